@@ -0,0 +1,79 @@
+/*
+ * Process-wide cache of Flutter AOT data.
+ */
+
+#include <string.h>
+
+#include <obs-module.h>
+
+#include "aot-cache.h"
+#include "engine-procs.h"
+#include "portable.h"
+
+struct aot_entry {
+	struct aot_entry *next;
+	char *elf_path;
+	FlutterEngineAOTData data;
+	long refs;
+};
+
+static struct aot_entry *g_entries;
+static pt_rwlock g_lock = PT_RWLOCK_INIT;
+
+FlutterEngineAOTData aot_cache_acquire(const char *elf_path)
+{
+	FlutterEngineAOTData data = NULL;
+	if (!g_embedder.CreateAOTData)
+		return NULL;
+
+	pt_rwlock_write_lock(&g_lock);
+	for (struct aot_entry *e = g_entries; e; e = e->next) {
+		if (strcmp(e->elf_path, elf_path) == 0) {
+			e->refs++;
+			data = e->data;
+			break;
+		}
+	}
+
+	if (!data) {
+		const FlutterEngineAOTDataSource src = {
+			.type = kFlutterEngineAOTDataSourceTypeElfPath,
+			.elf_path = elf_path,
+		};
+		if (g_embedder.CreateAOTData(&src, &data) == kSuccess) {
+			struct aot_entry *e = bzalloc(sizeof(*e));
+			e->elf_path = bstrdup(elf_path);
+			e->data = data;
+			e->refs = 1;
+			e->next = g_entries;
+			g_entries = e;
+			blog(LOG_INFO, "[FlutterSource] mapped AOT data %s", elf_path);
+		} else {
+			data = NULL;
+		}
+	}
+	pt_rwlock_write_unlock(&g_lock);
+	return data;
+}
+
+void aot_cache_release(FlutterEngineAOTData data)
+{
+	if (!data)
+		return;
+
+	pt_rwlock_write_lock(&g_lock);
+	for (struct aot_entry **it = &g_entries; *it; it = &(*it)->next) {
+		struct aot_entry *e = *it;
+		if (e->data != data)
+			continue;
+		if (--e->refs == 0) {
+			*it = e->next;
+			g_embedder.CollectAOTData(e->data);
+			blog(LOG_INFO, "[FlutterSource] collected AOT data %s", e->elf_path);
+			bfree(e->elf_path);
+			bfree(e);
+		}
+		break;
+	}
+	pt_rwlock_write_unlock(&g_lock);
+}
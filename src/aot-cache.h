@@ -0,0 +1,18 @@
+/*
+ * Process-wide cache of Flutter AOT data.
+ *
+ * Every engine running the same app.so shares one FlutterEngineAOTData
+ * (and so one mapping of the ELF).  Entries are keyed by the ELF path and
+ * reference counted; the data is collected when the last engine using it
+ * releases it, after FlutterEngineShutdown().
+ */
+
+#pragma once
+
+#include "flutter_embedder.h"
+
+/* Returns the shared AOT data for `elf_path`, loading it on first use, or
+ * NULL when the file can't be loaded (JIT builds run without it). */
+FlutterEngineAOTData aot_cache_acquire(const char *elf_path);
+
+void aot_cache_release(FlutterEngineAOTData data);
@@ -0,0 +1,232 @@
+/*
+ * Level / spectrum analysis for audio-reactive Flutter overlays.
+ *
+ * The FFT is an iterative radix-2 transform over split real/imaginary
+ * arrays.  Twiddles are stored per stage so that every butterfly stage
+ * reads them contiguously; stages with at least four butterflies run four
+ * at a time with SSE, the first two stages run scalar.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define ANALYSIS_SSE 1
+#endif
+
+#include "audio-analysis.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+uint32_t audio_analysis_clamp_fft_size(uint32_t n)
+{
+	uint32_t size = ANALYSIS_MIN_FFT;
+	while (size < n && size < ANALYSIS_MAX_FFT)
+		size <<= 1;
+	return size;
+}
+
+static uint32_t log2u(uint32_t n)
+{
+	uint32_t bits = 0;
+	while ((1u << bits) < n)
+		++bits;
+	return bits;
+}
+
+bool audio_analysis_init(struct audio_analysis *a, uint32_t fft_size, uint32_t sample_rate,
+			 enum analysis_stream stream)
+{
+	memset(a, 0, sizeof(*a));
+
+	const uint32_t n = audio_analysis_clamp_fft_size(fft_size);
+	const uint32_t bits = log2u(n);
+
+	a->history = calloc(n, sizeof(float));
+	a->window = malloc(sizeof(float) * n);
+	a->re = malloc(sizeof(float) * n);
+	a->im = malloc(sizeof(float) * n);
+	a->tw_re = malloc(sizeof(float) * n); /* sum of n/2^s over stages = n - 1 */
+	a->tw_im = malloc(sizeof(float) * n);
+	a->bitrev = malloc(sizeof(uint32_t) * n);
+	a->packet_size = sizeof(uint32_t) * ANALYSIS_HEADER_WORDS + sizeof(float) * (n / 2);
+	a->packet = calloc(1, a->packet_size);
+
+	if (!a->history || !a->window || !a->re || !a->im || !a->tw_re || !a->tw_im || !a->bitrev || !a->packet) {
+		audio_analysis_free(a);
+		return false;
+	}
+
+	/* Hann window */
+	for (uint32_t i = 0; i < n; ++i)
+		a->window[i] = (float)(0.5 - 0.5 * cos(2.0 * M_PI * i / (n - 1)));
+
+	for (uint32_t i = 0; i < n; ++i) {
+		uint32_t r = 0;
+		for (uint32_t b = 0; b < bits; ++b)
+			r |= ((i >> b) & 1u) << (bits - 1 - b);
+		a->bitrev[i] = r;
+	}
+
+	uint32_t off = 0;
+	for (uint32_t len = 2; len <= n; len <<= 1) {
+		const uint32_t half = len / 2;
+		for (uint32_t j = 0; j < half; ++j) {
+			const double angle = -2.0 * M_PI * j / len;
+			a->tw_re[off + j] = (float)cos(angle);
+			a->tw_im[off + j] = (float)sin(angle);
+		}
+		off += half;
+	}
+
+	a->fft_size = n;
+	a->sample_rate = sample_rate;
+	a->stream = stream;
+	return true;
+}
+
+void audio_analysis_free(struct audio_analysis *a)
+{
+	free(a->history);
+	free(a->window);
+	free(a->re);
+	free(a->im);
+	free(a->tw_re);
+	free(a->tw_im);
+	free(a->bitrev);
+	free(a->packet);
+	memset(a, 0, sizeof(*a));
+}
+
+void audio_analysis_feed(struct audio_analysis *a, const float *left, const float *right, uint32_t frames)
+{
+	if (!a->fft_size)
+		return;
+
+	const uint32_t mask = a->fft_size - 1;
+	uint32_t pos = a->history_pos;
+	double sum_l = 0.0, sum_r = 0.0;
+	float peak_l = a->peak[0], peak_r = a->peak[1];
+
+	for (uint32_t i = 0; i < frames; ++i) {
+		const float l = left[i];
+		const float r = right[i];
+		sum_l += (double)l * l;
+		sum_r += (double)r * r;
+		if (fabsf(l) > peak_l)
+			peak_l = fabsf(l);
+		if (fabsf(r) > peak_r)
+			peak_r = fabsf(r);
+		a->history[pos] = 0.5f * (l + r);
+		pos = (pos + 1) & mask;
+	}
+
+	a->history_pos = pos;
+	a->sum_sq[0] += sum_l;
+	a->sum_sq[1] += sum_r;
+	a->peak[0] = peak_l;
+	a->peak[1] = peak_r;
+	a->frames += frames;
+}
+
+static void fft_run(struct audio_analysis *a)
+{
+	const uint32_t n = a->fft_size;
+	float *re = a->re, *im = a->im;
+	uint32_t off = 0;
+
+	for (uint32_t len = 2; len <= n; len <<= 1) {
+		const uint32_t half = len / 2;
+		const float *wr = a->tw_re + off;
+		const float *wi = a->tw_im + off;
+
+		for (uint32_t k = 0; k < n; k += len) {
+			float *ar = re + k, *ai = im + k;
+			float *br = ar + half, *bi = ai + half;
+			uint32_t j = 0;
+#ifdef ANALYSIS_SSE
+			for (; j + 4 <= half; j += 4) {
+				const __m128 w_r = _mm_loadu_ps(wr + j);
+				const __m128 w_i = _mm_loadu_ps(wi + j);
+				const __m128 x_r = _mm_loadu_ps(br + j);
+				const __m128 x_i = _mm_loadu_ps(bi + j);
+				const __m128 t_r = _mm_sub_ps(_mm_mul_ps(x_r, w_r), _mm_mul_ps(x_i, w_i));
+				const __m128 t_i = _mm_add_ps(_mm_mul_ps(x_r, w_i), _mm_mul_ps(x_i, w_r));
+				const __m128 u_r = _mm_loadu_ps(ar + j);
+				const __m128 u_i = _mm_loadu_ps(ai + j);
+				_mm_storeu_ps(ar + j, _mm_add_ps(u_r, t_r));
+				_mm_storeu_ps(ai + j, _mm_add_ps(u_i, t_i));
+				_mm_storeu_ps(br + j, _mm_sub_ps(u_r, t_r));
+				_mm_storeu_ps(bi + j, _mm_sub_ps(u_i, t_i));
+			}
+#endif
+			for (; j < half; ++j) {
+				const float t_r = br[j] * wr[j] - bi[j] * wi[j];
+				const float t_i = br[j] * wi[j] + bi[j] * wr[j];
+				const float u_r = ar[j], u_i = ai[j];
+				ar[j] = u_r + t_r;
+				ai[j] = u_i + t_i;
+				br[j] = u_r - t_r;
+				bi[j] = u_i - t_i;
+			}
+		}
+		off += half;
+	}
+}
+
+const uint8_t *audio_analysis_pack(struct audio_analysis *a)
+{
+	if (!a->fft_size)
+		return NULL;
+
+	const uint32_t n = a->fft_size;
+	const uint32_t mask = n - 1;
+
+	/* oldest sample first, windowed, written in bit-reversed order */
+	for (uint32_t i = 0; i < n; ++i) {
+		const uint32_t dst = a->bitrev[i];
+		a->re[dst] = a->history[(a->history_pos + i) & mask] * a->window[i];
+		a->im[dst] = 0.f;
+	}
+
+	fft_run(a);
+
+	uint32_t *hdr = (uint32_t *)a->packet;
+	float *hdr_f = (float *)a->packet;
+	const double frames = a->frames ? (double)a->frames : 1.0;
+
+	hdr[0] = ANALYSIS_PACKET_MAGIC;
+	hdr[1] = a->stream;
+	hdr[2] = n / 2;
+	hdr[3] = a->sample_rate;
+	hdr_f[4] = (float)sqrt(a->sum_sq[0] / frames);
+	hdr_f[5] = (float)sqrt(a->sum_sq[1] / frames);
+	hdr_f[6] = a->peak[0];
+	hdr_f[7] = a->peak[1];
+
+	/* single-sided magnitude, normalised so a full-scale sine reads ~1.0 */
+	float *bins = hdr_f + ANALYSIS_HEADER_WORDS;
+	const float scale = 4.f / (float)n;
+	uint32_t i = 0;
+#ifdef ANALYSIS_SSE
+	const __m128 s = _mm_set1_ps(scale);
+	for (; i + 4 <= n / 2; i += 4) {
+		const __m128 r = _mm_loadu_ps(a->re + i);
+		const __m128 m = _mm_loadu_ps(a->im + i);
+		const __m128 mag = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(r, r), _mm_mul_ps(m, m)));
+		_mm_storeu_ps(bins + i, _mm_mul_ps(mag, s));
+	}
+#endif
+	for (; i < n / 2; ++i)
+		bins[i] = sqrtf(a->re[i] * a->re[i] + a->im[i] * a->im[i]) * scale;
+
+	a->sum_sq[0] = a->sum_sq[1] = 0.0;
+	a->peak[0] = a->peak[1] = 0.f;
+	a->frames = 0;
+
+	return a->packet;
+}
@@ -0,0 +1,67 @@
+/*
+ * Level / spectrum analysis for audio-reactive Flutter overlays.
+ *
+ * An analyser keeps the last `fft_size` mono samples of a stereo stream,
+ * tracks per-channel RMS/peak since the last packet and, on request, packs
+ * everything into a compact little-endian float32 packet that is handed to
+ * Dart as a Uint8List (see README for the layout).
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ANALYSIS_MIN_FFT 64
+#define ANALYSIS_MAX_FFT 8192
+
+#define ANALYSIS_PACKET_MAGIC 0x4153424Fu /* "OBSA" */
+#define ANALYSIS_HEADER_WORDS 8
+
+enum analysis_stream {
+	ANALYSIS_STREAM_MIX = 0,    /* the plug-in's own miniaudio mix */
+	ANALYSIS_STREAM_SOURCE = 1, /* a captured OBS source */
+};
+
+struct audio_analysis {
+	uint32_t fft_size;    /* power of two, 0 when uninitialised */
+	uint32_t stream;      /* enum analysis_stream */
+	uint32_t sample_rate; /* lets Dart map bins to Hz */
+
+	/* sliding window of mono samples (ring) */
+	float *history;
+	uint32_t history_pos;
+
+	/* level accumulators since the last packet */
+	double sum_sq[2];
+	float peak[2];
+	uint32_t frames;
+
+	/* FFT scratch, split re/im so butterflies vectorise */
+	float *window;
+	float *re, *im;
+	float *tw_re, *tw_im; /* per-stage twiddles, stage after stage */
+	uint32_t *bitrev;
+
+	/* output packet: header + fft_size / 2 magnitudes */
+	uint8_t *packet;
+	size_t packet_size;
+};
+
+bool audio_analysis_init(struct audio_analysis *a, uint32_t fft_size, uint32_t sample_rate,
+			 enum analysis_stream stream);
+void audio_analysis_free(struct audio_analysis *a);
+
+/* Feeds planar stereo samples (R may equal L for mono sources). */
+void audio_analysis_feed(struct audio_analysis *a, const float *left, const float *right, uint32_t frames);
+
+/*
+ * Runs the FFT over the current window, writes the packet and resets the
+ * level accumulators.  Returns a pointer to `a->packet_size` bytes that stay
+ * valid until the next call.
+ */
+const uint8_t *audio_analysis_pack(struct audio_analysis *a);
+
+/* Rounds `n` to a supported FFT size (power of two in [MIN, MAX]). */
+uint32_t audio_analysis_clamp_fft_size(uint32_t n);
@@ -0,0 +1,117 @@
+/*
+ * Platform-channel handler registry.
+ */
+
+#include <string.h>
+
+#include <obs-module.h>
+
+#include "channel-registry.h"
+
+#define SLOT_MASK (CHANNEL_REGISTRY_SLOTS - 1)
+
+static uint32_t channel_hash(const char *name, size_t *len_out)
+{
+	uint32_t h = 2166136261u;
+	const unsigned char *p = (const unsigned char *)name;
+	while (*p) {
+		h ^= *p++;
+		h *= 16777619u;
+	}
+	*len_out = (size_t)((const char *)p - name);
+	return h;
+}
+
+static struct channel_entry *lookup(const struct channel_registry *reg, const char *name)
+{
+	size_t len;
+	const uint32_t hash = channel_hash(name, &len);
+
+	for (uint32_t i = 0; i < CHANNEL_REGISTRY_SLOTS; ++i) {
+		const struct channel_entry *e = &reg->slots[(hash + i) & SLOT_MASK];
+		if (!e->name)
+			return NULL;
+		if (e->hash == hash && e->len == len && memcmp(e->name, name, len) == 0)
+			return (struct channel_entry *)e;
+	}
+	return NULL;
+}
+
+void channel_registry_init(struct channel_registry *reg)
+{
+	memset(reg, 0, sizeof(*reg));
+}
+
+void channel_registry_free(struct channel_registry *reg)
+{
+	for (uint32_t i = 0; i < CHANNEL_REGISTRY_SLOTS; ++i)
+		bfree(reg->slots[i].name);
+	memset(reg, 0, sizeof(*reg));
+}
+
+bool channel_registry_add(struct channel_registry *reg, const char *name, channel_handler_fn handler,
+			  void *user_data)
+{
+	struct channel_entry *existing = lookup(reg, name);
+	if (existing) {
+		existing->handler = handler;
+		existing->user_data = user_data;
+		return true;
+	}
+
+	if (reg->count * 2 >= CHANNEL_REGISTRY_SLOTS) {
+		blog(LOG_ERROR, "[FlutterSource] channel registry full, can't add '%s'", name);
+		return false;
+	}
+
+	size_t len;
+	const uint32_t hash = channel_hash(name, &len);
+	uint32_t i = hash & SLOT_MASK;
+	while (reg->slots[i].name)
+		i = (i + 1) & SLOT_MASK;
+
+	struct channel_entry *e = &reg->slots[i];
+	e->name = bstrdup(name);
+	e->len = len;
+	e->hash = hash;
+	e->handler = handler;
+	e->user_data = user_data;
+	reg->count++;
+	return true;
+}
+
+const struct channel_entry *channel_registry_find(const struct channel_registry *reg, const char *name)
+{
+	return lookup(reg, name);
+}
+
+bool channel_registry_dispatch(struct channel_registry *reg, const FlutterPlatformMessage *msg,
+			       const struct channel_entry **entry)
+{
+	struct channel_entry *e = lookup(reg, msg->channel);
+	if (!e || !e->handler) {
+		if (entry)
+			*entry = NULL;
+		reg->unhandled++;
+		return false;
+	}
+
+	if (entry)
+		*entry = e;
+	e->messages++;
+	e->bytes += msg->message_size;
+	return e->handler(e->user_data, msg);
+}
+
+void channel_registry_log_stats(const struct channel_registry *reg)
+{
+	for (uint32_t i = 0; i < CHANNEL_REGISTRY_SLOTS; ++i) {
+		const struct channel_entry *e = &reg->slots[i];
+		if (e->name && e->messages)
+			blog(LOG_INFO, "[FlutterSource] channel %-16s %llu msg, %llu bytes", e->name,
+			     (unsigned long long)e->messages, (unsigned long long)e->bytes);
+	}
+	if (reg->unhandled)
+		blog(LOG_INFO, "[FlutterSource] %llu message(s) on unregistered channels",
+		     (unsigned long long)reg->unhandled);
+}
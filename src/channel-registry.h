@@ -0,0 +1,54 @@
+/*
+ * Platform-channel handler registry.
+ *
+ * Channel names are interned once at registration; incoming messages are
+ * routed through an open-addressing hash table (FNV-1a over the name), so
+ * dispatch cost does not grow with the number of channels.  Each channel
+ * keeps message and byte counters for diagnostics.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "flutter_embedder.h"
+
+#define CHANNEL_REGISTRY_SLOTS 256 // power of two, keep at least 2x the channel count (4 per view + 4)
+
+/* Returns true when the handler has already replied to `msg->response_handle`. */
+typedef bool (*channel_handler_fn)(void *user_data, const FlutterPlatformMessage *msg);
+
+struct channel_entry {
+	char *name; // interned copy, NULL for an empty slot
+	size_t len;
+	uint32_t hash;
+	channel_handler_fn handler;
+	void *user_data;
+
+	uint64_t messages;
+	uint64_t bytes;
+};
+
+struct channel_registry {
+	struct channel_entry slots[CHANNEL_REGISTRY_SLOTS];
+	uint32_t count;
+	uint64_t unhandled; // messages on channels without a handler
+};
+
+void channel_registry_init(struct channel_registry *reg);
+void channel_registry_free(struct channel_registry *reg);
+
+/* Binds `name` to `handler`, replacing an existing binding.  A NULL handler
+ * unbinds the channel; its name and counters are kept for reuse. */
+bool channel_registry_add(struct channel_registry *reg, const char *name, channel_handler_fn handler,
+			  void *user_data);
+const struct channel_entry *channel_registry_find(const struct channel_registry *reg, const char *name);
+
+/* Routes `msg` to its handler; returns the handler's result, false if none.
+ * `entry` (optional) receives the handling entry, NULL if there was none. */
+bool channel_registry_dispatch(struct channel_registry *reg, const FlutterPlatformMessage *msg,
+			       const struct channel_entry **entry);
+
+void channel_registry_log_stats(const struct channel_registry *reg);
@@ -0,0 +1,47 @@
+/*
+ * JSON merge patches (RFC 7396) for incremental dart_config delivery.
+ */
+
+#include "config-patch.h"
+
+bool config_patchable(const cJSON *from, const cJSON *to)
+{
+	return cJSON_IsObject(from) && cJSON_IsObject(to);
+}
+
+static void add_member(cJSON **patch, const char *key, cJSON *value)
+{
+	if (!*patch)
+		*patch = cJSON_CreateObject();
+	cJSON_AddItemToObject(*patch, key, value);
+}
+
+cJSON *config_merge_patch(const cJSON *from, const cJSON *to)
+{
+	cJSON *patch = NULL;
+	const cJSON *it;
+
+	cJSON_ArrayForEach(it, from)
+	{
+		if (!cJSON_GetObjectItemCaseSensitive(to, it->string))
+			add_member(&patch, it->string, cJSON_CreateNull());
+	}
+
+	cJSON_ArrayForEach(it, to)
+	{
+		const cJSON *old = cJSON_GetObjectItemCaseSensitive(from, it->string);
+		cJSON *change = NULL;
+
+		if (!old)
+			change = cJSON_Duplicate(it, true);
+		else if (config_patchable(old, it))
+			change = config_merge_patch(old, it);
+		else if (!cJSON_Compare(old, it, true))
+			change = cJSON_Duplicate(it, true);
+
+		if (change)
+			add_member(&patch, it->string, change);
+	}
+
+	return patch;
+}
@@ -0,0 +1,22 @@
+/*
+ * JSON merge patches (RFC 7396) for incremental dart_config delivery.
+ *
+ * A patch lists only the keys that changed: nested objects are diffed
+ * recursively, removed keys are sent as null and every other value
+ * (including arrays) is replaced whole.  Merge patches cannot set a value
+ * to null; such a key reads as removed on the Dart side.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "./third_party/cjson/cJSON.h"
+
+/* True when both documents have an object root, i.e. a patch can express
+ * the change.  Otherwise the whole new document has to be sent. */
+bool config_patchable(const cJSON *from, const cJSON *to);
+
+/* Patch turning `from` into `to`, or NULL when nothing changed.  Both roots
+ * must be objects.  Free with cJSON_Delete(). */
+cJSON *config_merge_patch(const cJSON *from, const cJSON *to);
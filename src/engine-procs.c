@@ -0,0 +1,61 @@
+/*
+ * Flutter embedder API resolved at runtime.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <obs-module.h>
+#include <util/platform.h>
+
+#include "engine-procs.h"
+#include "portable.h"
+
+FlutterEngineProcTable g_embedder;
+
+static void *g_library;
+
+bool embedder_load(const char *path)
+{
+	if (g_library)
+		return true;
+	if (!path || !path[0])
+		path = FLUTTER_ENGINE_LIBRARY;
+
+	/* relative names resolve against the plug-in directory, not the cwd */
+	char full[MAX_PATH], dir[MAX_PATH];
+	if (!pt_path_is_absolute(path) && pt_module_dir(dir, sizeof(dir)))
+		snprintf(full, sizeof(full), "%s" PT_PATH_SEP "%s", dir, path);
+	else
+		snprintf(full, sizeof(full), "%s", path);
+
+	void *lib = os_dlopen(full);
+	if (!lib) {
+		blog(LOG_ERROR, "[FlutterSource] can't load the Flutter engine from %s", full);
+		return false;
+	}
+
+	typedef FlutterEngineResult (*get_proc_addresses_fn)(FlutterEngineProcTable *);
+	const get_proc_addresses_fn get = (get_proc_addresses_fn)os_dlsym(lib, "FlutterEngineGetProcAddresses");
+
+	FlutterEngineProcTable table = {.struct_size = sizeof(table)};
+	if (!get || get(&table) != kSuccess) {
+		blog(LOG_ERROR, "[FlutterSource] %s doesn't export FlutterEngineGetProcAddresses", path);
+		os_dlclose(lib);
+		return false;
+	}
+
+	g_embedder = table;
+	g_library = lib;
+	blog(LOG_INFO, "[FlutterSource] Flutter engine loaded from %s", path);
+	return true;
+}
+
+void embedder_unload(void)
+{
+	if (!g_library)
+		return;
+	memset(&g_embedder, 0, sizeof(g_embedder));
+	os_dlclose(g_library);
+	g_library = NULL;
+}
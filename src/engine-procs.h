@@ -0,0 +1,29 @@
+/*
+ * Flutter embedder API resolved at runtime.
+ *
+ * The engine library is loaded when the first source needs it instead of
+ * being linked, so the plug-in itself loads without it and any engine build
+ * that exports FlutterEngineGetProcAddresses can be dropped in.  All engine
+ * calls go through g_embedder.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "flutter_embedder.h"
+
+#ifndef FLUTTER_ENGINE_LIBRARY
+#define FLUTTER_ENGINE_LIBRARY "flutter_engine.dll"
+#endif
+
+/* Zeroed until embedder_load() succeeds. */
+extern FlutterEngineProcTable g_embedder;
+
+/* Loads the engine from `path` (UTF-8).  Relative paths are resolved
+ * against the plug-in's directory; NULL or "" means FLUTTER_ENGINE_LIBRARY.
+ * Does nothing once a library is loaded. */
+bool embedder_load(const char *path);
+
+/* Module unload, after every engine has been shut down. */
+void embedder_unload(void);
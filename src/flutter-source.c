@@ -1,31 +1,43 @@
 /*
- * OBS Studio source plug‑in that embeds the Flutter engine on Windows.
+ * OBS Studio source plug‑in that embeds the Flutter engine (Windows, Linux).
  * The engine runs on a dedicated worker thread and communicates with OBS
  * via a software texture.  A custom platform task‑runner is used so that
  * all platform messages are executed on the same worker thread.
  *
  * Build:  drop this file into an OBS plug‑in project and link against
- *         the Flutter Embedder DLL + libobs.
+ *         libobs.  The Flutter engine DLL is loaded at runtime (engine-procs.c).
  */
 
-//  ────────────────   Standard library / Windows   ────────────────
+//  ────────────────   Standard library / platform   ────────────────
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
-#include <windows.h>
-#include <Shlwapi.h>
-#pragma comment(lib, "Shlwapi.lib")
+#include "portable.h"
 
 //  ────────────────   OBS & Flutter headers   ────────────────
 #include <obs-module.h>
 #include <graphics/graphics.h>
+#include <graphics/vec2.h>
 #include "flutter_embedder.h"
 
 //  ────────────────   Audio   ────────────────
 #include "./third_party/miniaudio/miniaudio.h"
 #include <util/platform.h>
+#include "audio-analysis.h"
 
 #include <string.h>                    /* strncpy */
 #include "./third_party/cjson/cJSON.h" /* third_party/cjson/cJSON.{h,c} */
+#include "channel-registry.h"
+#include "standard-codec.h"
+#include "json-arena.h"
+#include "config-patch.h"
+#include "texture-pool.h"
+#include "aot-cache.h"
+#include "engine-procs.h"
+#include "latency-histogram.h"
+#include "thread-sched.h"
+#include "quality-governor.h"
+#include "obs-flutter-api.h"
 
 //  ────────────────────────────────────────────────────────────────
 //  Worker‑thread infrastructure
@@ -35,17 +47,25 @@ typedef enum {
 	CMD_CREATE_ENGINE,
 	CMD_DESTROY_ENGINE,
 	CMD_RUN_ENGINE_TASK, // Execute a pending FlutterTask
+	CMD_FLUSH_REPLIES,   // Send obs_audio replies completed off-thread
+	CMD_SEND_CONFIG,     // Deliver the debounced dart_config
+	CMD_FREE_HOST,       // Release a shut-down engine host after its queued tasks
+	CMD_FILL_POOL,       // Initialize warm engines up to the configured count
+	CMD_TRIM_POOL,       // Shut down warm engines idle for too long
+	CMD_VIEW_REFUSED,    // Move a source a shared engine refused to an engine of its own
 	CMD_EXIT,
 } command_type_t;
 
 struct flutter_source; // forward declaration
+struct flutter_host;
 
 typedef struct {
 	command_type_t type;
 	struct flutter_source *ctx; // source instance owner
+	struct flutter_host *host;  // engine owner, CMD_RUN_ENGINE_TASK / CMD_FREE_HOST
 	FlutterTask task;           // used by CMD_RUN_ENGINE_TASK
 	uint64_t target_time_ns;    //   "    "
-	HANDLE done_event;          // event to signal when cmd is done
+	pt_sem *done;               // posted when cmd is done
 } command_t;
 
 #define QUEUE_CAPACITY 128
@@ -53,22 +73,45 @@ typedef struct {
 typedef struct {
 	command_t items[QUEUE_CAPACITY];
 	int head, tail; // ring‑buffer indexes
-	CRITICAL_SECTION cs;
-	HANDLE sem; // counts pending commands
+	pt_mutex cs;
+	pt_sem sem; // counts pending commands
 } command_queue_t;
 
 // START Audio Engine
 typedef enum { CMD_LOAD, CMD_PLAY, CMD_STOP, CMD_VOLUME } cmd_type;
 
+/* Deferred reply for one obs_audio message.  It completes once every
+ * command it carries has been applied and every load in it has decoded. */
+typedef struct audio_reply {
+	struct audio_reply *next; // completion stack link
+	const FlutterPlatformMessageResponseHandle *handle;
+	bool method_call;      // StandardMethodCodec envelope vs JSON
+	volatile long pending; // commands still outstanding (+1 while submitting)
+	volatile long failed;
+	float duration;    // of the last load, seconds
+	uint32_t channels; //   "    "
+} audio_reply;
+
 typedef struct {
 	cmd_type type;
 	int id;
 	float volume;
 	bool loop;
-	bool is_relative; /* true  -> path needs assets_dir prefix */
-	char path[260];   // UTF-8, asset path
+	bool is_relative;   /* true  -> path needs assets_dir prefix */
+	char path[260];     // UTF-8, asset path
+	audio_reply *reply; // NULL when nobody awaits the result
 } audio_cmd;
 
+/* An asynchronous load someone is waiting for.  miniaudio signals `cb` from
+ * a resource-manager job thread; the audio tick picks the result up. */
+typedef struct pending_load {
+	ma_async_notification_callbacks cb; // must stay first
+	volatile long decoded;
+	int id;
+	audio_reply *reply;
+	struct pending_load *next;
+} pending_load;
+
 #define QUEUE_SIZE 128
 typedef struct {
 	audio_cmd items[QUEUE_SIZE];
@@ -84,6 +127,23 @@ static bool push(cmd_queue *q, const audio_cmd *in)
 	q->head = next;
 	return true;
 }
+/* All-or-nothing: the batch becomes visible to the audio thread with a
+ * single head update, so one audio_tick drains it as a whole. */
+static bool push_batch(cmd_queue *q, const audio_cmd *in, uint32_t count)
+{
+	const uint32_t used = (q->head + QUEUE_SIZE - q->tail) % QUEUE_SIZE;
+	if (count > QUEUE_SIZE - 1 - used)
+		return false;
+
+	uint32_t head = q->head;
+	for (uint32_t i = 0; i < count; ++i) {
+		q->items[head] = in[i];
+		head = (head + 1) % QUEUE_SIZE;
+	}
+	pt_memory_barrier();
+	q->head = head;
+	return true;
+}
 static bool pop(cmd_queue *q, audio_cmd *out)
 {
 	if (q->tail == q->head)
@@ -92,49 +152,49 @@ static bool pop(cmd_queue *q, audio_cmd *out)
 	q->tail = (q->tail + 1) % QUEUE_SIZE;
 	return true;
 }
-static cmd_queue g_cmdq = {0};
+#define AUDIO_BATCH_MAX 64 // commands accepted in one obs_audio message
 // END Audio Engine
 
 static command_queue_t g_queue;
-static HANDLE g_worker_thread = NULL;
-static DWORD g_worker_tid = 0;  // thread id
-static LONG g_source_count = 0; // active sources
+static pt_thread g_worker_thread;
+static bool g_worker_running = false;
+static volatile long g_source_count = 0; // active sources
 
 // ––– queue helpers ––––––––––––––––––––––––––––––––––––––––––––
 static void queue_init(command_queue_t *q)
 {
-	InitializeCriticalSection(&q->cs);
-	q->sem = CreateSemaphore(NULL, 0, QUEUE_CAPACITY, NULL);
+	pt_mutex_init(&q->cs);
+	pt_sem_init(&q->sem, 0);
 	q->head = q->tail = 0;
 }
 
 static void queue_destroy(command_queue_t *q)
 {
-	DeleteCriticalSection(&q->cs);
-	CloseHandle(q->sem);
+	pt_mutex_destroy(&q->cs);
+	pt_sem_destroy(&q->sem);
 }
 
 static void queue_push(command_queue_t *q, const command_t *cmd)
 {
-	EnterCriticalSection(&q->cs);
+	pt_mutex_lock(&q->cs);
 	q->items[q->tail] = *cmd;
 	q->tail = (q->tail + 1) % QUEUE_CAPACITY;
-	LeaveCriticalSection(&q->cs);
-	ReleaseSemaphore(q->sem, 1, NULL);
+	pt_mutex_unlock(&q->cs);
+	pt_sem_post(&q->sem);
 }
 
 static bool queue_pop(command_queue_t *q, command_t *out)
 {
-	WaitForSingleObject(q->sem, INFINITE);
+	pt_sem_wait(&q->sem);
 
-	EnterCriticalSection(&q->cs);
+	pt_mutex_lock(&q->cs);
 	if (q->head == q->tail) {
-		LeaveCriticalSection(&q->cs);
+		pt_mutex_unlock(&q->cs);
 		return false;
 	}
 	*out = q->items[q->head];
 	q->head = (q->head + 1) % QUEUE_CAPACITY;
-	LeaveCriticalSection(&q->cs);
+	pt_mutex_unlock(&q->cs);
 	return true;
 }
 
@@ -142,65 +202,369 @@ static bool queue_pop(command_queue_t *q, command_t *out)
 //  OBS <‑‑> Flutter source structure
 //  ────────────────────────────────────────────────────────────────
 
+#define DEFAULT_DART_CONFIG "{\n\t\n}"
+#define CONFIG_DEBOUNCE_NS (300 * 1000000ULL) // quiet period before a config edit is sent
+#define RESIZE_SETTLE_NS (80 * 1000000ULL)    // quiet period before a new size is applied
+#define UPLOAD_RING 3                         // shown + being written + mapped spare
+
+/* Frames reach the GPU through a ring of dynamic textures.  The graphics
+ * thread keeps spare slots mapped; the raster thread copies a frame straight
+ * into one and marks it filled; the next render unmaps it and draws it while
+ * the others are refilled.  Only the map/unmap calls stay on the graphics
+ * thread. */
+enum upload_state {
+	SLOT_IDLE,    // unmapped, not shown
+	SLOT_MAPPED,  // mapped, waiting for a frame
+	SLOT_WRITING, // raster thread is copying into it (outside tex_cs)
+	SLOT_FILLED,  // mapped, holds a complete frame
+	SLOT_SHOWN,   // unmapped, being drawn
+};
+
+struct upload_slot {
+	gs_texture_t *tex;
+	uint32_t width, height;
+	enum upload_state state;
+	uint8_t *ptr; // valid while mapped
+	uint32_t linesize;
+	uint64_t seq; // frame number of the contents
+	uint64_t present_ns; // when the engine presented it
+};
+
 struct flutter_source {
 	// OBS data
 	obs_source_t *source;
 
 	// Flutter data
-	FlutterEngine engine;
-	FlutterEngineAOTData aot_data;
-	uint32_t width, height;
+	struct flutter_host *host; // worker thread; NULL until attached
+	FlutterViewId view_id;
+	FlutterEngine engine; // host->engine while attached
+	bool shared_engine;   // join a running engine for the same app as another view
+	bool matte;           // Gray8 frames drawn as an alpha matte, fixed at creation
+	uint32_t width, height; // output size, graphics thread
 	uint32_t pixel_ratio_pct;
-	uint8_t *pixel_data; // RGBA buffer sent to texture
-	gs_texture_t *texture;
-	volatile LONG dirty_pixels;
-
-	// custom task‑runner bookkeeping
-	DWORD engine_tid; // worker thread id
-	FlutterTaskRunnerDescription platform_runner_desc;
-	FlutterCustomTaskRunners custom_runners;
+	uint32_t render_scale_pct; // engine frame size vs output size, graphics thread
+	bool bicubic_upscale;      // stretch scaled frames bicubic instead of bilinear
+	uint8_t *pixel_data; // fallback RGBA buffer while no mapped slot fits, under tex_cs
+	size_t pixel_cap;    // bytes allocated; only ever grows
+	uint64_t pixel_seq;
+	uint64_t pixel_present_ns;
+	uint32_t frame_width, frame_height, frame_stride; // last presented frame, under tex_cs
+	uint64_t frame_seq;                               //   "
+	struct upload_slot upload[UPLOAD_RING];           // states under tex_cs
+	int shown;                                        // slot drawn, -1 = none; graphics thread
+	volatile long dirty_pixels;
+
+	/* ----------   suspension   ---------- */
+	volatile long showing;  // show/hide
+	volatile long active;   // activate/deactivate
+	volatile long suspended; // set under tex_cs; graphics thread applies transitions
+	struct flutter_host *suspended_on; // host whose suspended_views counts this source
+	bool release_hidden;     // free frame buffers while suspended
+	bool release_pending;    // graphics thread: a slot was still being written
+
+	/* engine startup runs on the worker while OBS carries on */
+	volatile long started;        // host_attach finished, successfully or not
+	uint64_t create_ns;           // source_create
+	volatile int64_t first_frame_ns; // create -> first presented frame, 0 until then
+
+	/* graphics-thread cost of source_render */
+	volatile int64_t render_calls;
+	volatile int64_t render_ns_total;
+	volatile int64_t render_ns_max;
+
+	/* pipeline instrumentation, see log_pipeline_stats() */
+	volatile int64_t present_ns_total;          // raster thread copying frames
+	volatile int64_t audio_ns_total;            // audio timer in audio_tick
+	uint64_t frames_uploaded;                  // graphics thread
+	struct latency_histogram upload_latency;   // present -> drawable, graphics thread
+	struct latency_histogram audio_jitter;     // tick period error, audio timer
+	uint64_t last_audio_tick_ns;               //   "
+	struct quality_governor governor;          // graphics thread, see quality-governor.h
+
+	/* latest size from the properties; applied by video_tick once settled */
+	uint32_t req_width, req_height, req_ratio_pct; // under tex_cs
+	uint32_t req_render_scale_pct;                   //   "
+	bool req_governor;                               //   "
+	uint32_t req_min_scale_pct, req_max_divider;     //   "
+	volatile int64_t resize_due_ns;                  // 0 = nothing pending
+
+	/* ----------   Dart FFI   ---------- */
+	int64_t ffi_handle;
+	volatile long ffi_busy; // try-lock over ffi_cmdq's producer side
+	volatile int64_t frames_presented;
+	volatile int64_t audio_ticks;
+	volatile int64_t platform_messages;
 
 	/* ----------   audio   ---------- */
 	ma_engine ma;
 	ma_sound *sounds[256];
-	HANDLE audio_timer;
+	cmd_queue cmdq;     // platform thread -> audio timer
+	cmd_queue ffi_cmdq; // Dart FFI callers -> audio timer
+	pending_load *pending_loads;     // audio thread only
+	pending_load *cancelled_loads;   // may still be signalled; freed after ma_engine_uninit
+	struct preload_pool *volatile preload; // manifest still decoding; audio thread installs it
+	bool preload_started;                  // worker: once per source, whichever engine it runs on
+	audio_reply *volatile replies_done; // lock-free stack, audio -> platform thread
+	pt_timer *audio_timer;
 	float *mix_int;
 	float *mix_L;
 	float *mix_R;
 
-	/* base assets dir (UTF‑8) */
+	/* ----------   audio analysis   ---------- */
+	volatile int64_t analysis_port;      // Dart SendPort, 0 = disabled
+	volatile long analysis_fft_size;    // requested size, applied lazily
+	volatile long analysis_interval_ms; // packet period
+	struct audio_analysis mix_analysis; // audio timer thread only
+	uint64_t mix_analysis_due_ns;
+	struct audio_analysis src_analysis; // OBS audio thread only
+	uint64_t src_analysis_due_ns;
+	obs_weak_source_t *analysis_target; // captured OBS source
+	char analysis_target_name[256];
+
+	/* base assets dir (UTF‑8), copied from the host */
 	char assets_dir[MAX_PATH];
 
-	char dart_config[4096];
+	/* ----------   dart_config   ---------- */
+	char *dart_config;       // platform thread: what Dart has (or will get on request)
+	cJSON *dart_config_tree; //   "     "   : parsed dart_config, NULL if not JSON
+	bool config_delivered;   //   "     "   : Dart holds the full config, send patches
+	pt_mutex config_cs;
+	char *config_latest;             // newest text from the properties, under config_cs
+	volatile int64_t config_due_ns;   // debounce deadline, 0 = nothing pending
+
+	pt_mutex tex_cs;
+};
+
+#define HOST_MAX_VIEWS 16
+
+/* One running Flutter engine.  A dedicated host serves a single source
+ * through the implicit view; a shared host (multi-view mode) serves every
+ * source of the same app bundle, each as its own FlutterView with its own
+ * metrics and frame buffer.  Everything engine-wide (isolate, AOT data,
+ * channel registry, task runner) lives here. */
+struct flutter_host {
+	struct flutter_host *next; // g_hosts or the warm pool, worker thread
+	uint64_t warm_since_ns;    // initialized but not yet claimed
+	FlutterEngine engine;
+	FlutterEngineAOTData aot_data;
+	bool shared;                 // joinable by other sources (uses the compositor)
+	char assets_dir[MAX_PATH];   // app bundle, also the sharing key
+	uint64_t engine_tid;         // worker thread id
+	FlutterTaskRunnerDescription platform_runner_desc;
+	FlutterCustomTaskRunners custom_runners;
+	FlutterCompositor compositor;
+	struct channel_registry channels; // platform thread only
 
-	CRITICAL_SECTION tex_cs;
+	pt_rwlock views_lock;                            // exclusive: worker, shared: raster thread
+	struct flutter_source *views[HOST_MAX_VIEWS];  // by view id; 0 is the implicit view
+	volatile long removing[HOST_MAX_VIEWS];        // RemoveView not yet confirmed
+	volatile long view_count;                      // written by the worker
+	volatile long suspended_views;                 // written by the graphics thread
+
+	pt_mutex lifecycle_cs; // see host_update_lifecycle()
+	bool paused;
+
+	volatile int64_t vsync_baton; // from vsync_cb, 0 = none; see host_return_vsync()
+	uint64_t next_vsync_ns;       // graphics thread
 };
 
 //  ────────────────────────────────────────────────────────────────
 //  Forward declarations
 //  ────────────────────────────────────────────────────────────────
-static void engine_init(struct flutter_source *ctx);
-static void engine_shutdown(struct flutter_source *ctx);
+static void host_attach(struct flutter_source *ctx);
+static void host_detach(struct flutter_source *ctx);
+static void host_view_refused(struct flutter_source *ctx);
+static void host_free(struct flutter_host *host);
+static void host_update_lifecycle(struct flutter_host *host);
+static void warm_pool_fill(void);
+static void warm_pool_trim(void);
+static void warm_pool_drain(void);
+static void flush_audio_replies(struct flutter_source *ctx);
+static void send_config(struct flutter_source *ctx);
+static void upload_ring_free(struct flutter_source *ctx);
 
 //  ────────────────────────────────────────────────────────────────
 //  Logging helpers
 //  ────────────────────────────────────────────────────────────────
 static inline void log_tid(const char *tag)
 {
-	blog(LOG_INFO, "[%s] tid=%lu", tag, (unsigned long)GetCurrentThreadId());
+	blog(LOG_INFO, "[%s] tid=%llu", tag, (unsigned long long)pt_thread_id());
 }
 
 //  ────────────────────────────────────────────────────────────────
 //  Flutter embedder callbacks
 //  ────────────────────────────────────────────────────────────────
 
+static void copy_rows(uint8_t *dst, uint32_t dst_stride, const uint8_t *src, size_t src_stride, size_t row_bytes,
+		      size_t rows)
+{
+	if (dst_stride == src_stride) {
+		memcpy(dst, src, src_stride * rows);
+		return;
+	}
+	for (size_t y = 0; y < rows; ++y)
+		memcpy(dst + y * dst_stride, src + y * src_stride, row_bytes);
+}
+
+static void log_first_frame(struct flutter_source *ctx)
+{
+	const uint64_t ns = os_gettime_ns() - ctx->create_ns;
+	pt_atomic_xchg64(&ctx->first_frame_ns, (int64_t)ns);
+	blog(LOG_INFO, "[FlutterSource] first frame %.1f ms after creation (view %lld)", (double)ns / 1e6,
+	     (long long)ctx->view_id);
+}
+
+/* Raster thread.  A frame goes into a mapped upload slot of its size when
+ * one is ready.  Otherwise (first frame, new size) it goes into pixel_data.
+ * That buffer never shrinks and grows with a quarter extra, so a
+ * drag-resize settles without reallocating. */
+static bool copy_frame(struct flutter_source *ctx, const void *allocation, size_t row_bytes, size_t height,
+		       uint64_t now)
+{
+	const size_t size = row_bytes * height;
+	const uint32_t width = (uint32_t)(row_bytes / (ctx->matte ? 1 : 4));
+
+	pt_mutex_lock(&ctx->tex_cs);
+	if (ctx->suspended) { // frame still in flight when the source was hidden
+		pt_mutex_unlock(&ctx->tex_cs);
+		return true;
+	}
+	const uint64_t seq = ++ctx->frame_seq;
+	ctx->frame_width = width;
+	ctx->frame_height = (uint32_t)height;
+	ctx->frame_stride = (uint32_t)row_bytes;
+
+	struct upload_slot *slot = NULL;
+	for (int i = 0; i < UPLOAD_RING && !slot; ++i) {
+		struct upload_slot *u = &ctx->upload[i];
+		if (u->state == SLOT_MAPPED && u->width == width && u->height == height)
+			slot = u;
+	}
+	if (slot) {
+		slot->state = SLOT_WRITING;
+		pt_mutex_unlock(&ctx->tex_cs);
+
+		copy_rows(slot->ptr, slot->linesize, allocation, row_bytes, row_bytes, height);
+
+		pt_mutex_lock(&ctx->tex_cs);
+		slot->state = SLOT_FILLED;
+		slot->seq = seq;
+		slot->present_ns = now;
+		pt_mutex_unlock(&ctx->tex_cs);
+
+		pt_atomic_xchg(&ctx->dirty_pixels, 1);
+		if (pt_atomic_inc64(&ctx->frames_presented) == 1)
+			log_first_frame(ctx);
+		return true;
+	}
+
+	if (size > ctx->pixel_cap) {
+		const size_t cap = size + size / 4;
+		uint8_t *buf = malloc(cap);
+		if (!buf) {
+			pt_mutex_unlock(&ctx->tex_cs);
+			return false;
+		}
+		free(ctx->pixel_data);
+		ctx->pixel_data = buf;
+		ctx->pixel_cap = cap;
+	}
+	memcpy(ctx->pixel_data, allocation, size);
+	ctx->pixel_seq = seq;
+	ctx->pixel_present_ns = now;
+	pt_mutex_unlock(&ctx->tex_cs);
+
+	pt_atomic_xchg(&ctx->dirty_pixels, 1);
+	if (pt_atomic_inc64(&ctx->frames_presented) == 1)
+		log_first_frame(ctx);
+	return true;
+}
+
+static bool present_frame(struct flutter_source *ctx, const void *allocation, size_t row_bytes, size_t height)
+{
+	const uint64_t now = os_gettime_ns();
+	const bool ok = copy_frame(ctx, allocation, row_bytes, height, now);
+	pt_atomic_add64(&ctx->present_ns_total, (int64_t)(os_gettime_ns() - now));
+	return ok;
+}
+
+/* Frames for a view that is gone (or not yet claimed) are dropped. */
+static bool present_view(struct flutter_host *host, FlutterViewId view_id, const void *allocation, size_t row_bytes,
+			 size_t height)
+{
+	if (view_id < 0 || view_id >= HOST_MAX_VIEWS)
+		return true;
+
+	pt_rwlock_read_lock(&host->views_lock);
+	struct flutter_source *ctx = host->views[view_id];
+	const bool ok = ctx ? present_frame(ctx, allocation, row_bytes, height) : true;
+	pt_rwlock_read_unlock(&host->views_lock);
+	return ok;
+}
+
+/* Dedicated hosts: software renderer, implicit view only */
 static bool surface_present_cb(void *user_data, const void *allocation, size_t row_bytes, size_t height)
 {
-	struct flutter_source *ctx = user_data;
-	if (!ctx->pixel_data)
+	return present_view(user_data, 0, allocation, row_bytes, height);
+}
+
+//  Shared and matte hosts render every view through the compositor into software backing stores
+
+static void backing_store_noop(void *user_data)
+{
+	(void)user_data;
+}
+
+/* Matte views get Gray8 stores: the engine converts to BT.709 luma, a
+ * quarter of the bytes to copy and upload. */
+static bool create_backing_store_cb(const FlutterBackingStoreConfig *config, FlutterBackingStore *out, void *user_data)
+{
+	struct flutter_host *host = user_data;
+	bool matte = false;
+	if (config->view_id >= 0 && config->view_id < HOST_MAX_VIEWS) {
+		pt_rwlock_read_lock(&host->views_lock);
+		const struct flutter_source *view = host->views[config->view_id];
+		matte = view && view->matte;
+		pt_rwlock_read_unlock(&host->views_lock);
+	}
+
+	const size_t row_bytes = (size_t)config->size.width * (matte ? 1 : 4);
+	const size_t height = (size_t)config->size.height;
+	void *pixels = calloc(height, row_bytes);
+	if (!pixels)
 		return false;
-	memcpy(ctx->pixel_data, allocation, row_bytes * height);
-	InterlockedExchange(&ctx->dirty_pixels, 1);
+
+	out->type = kFlutterBackingStoreTypeSoftware2;
+	out->user_data = pixels;
+	out->software2 = (FlutterSoftwareBackingStore2){
+		.struct_size = sizeof(FlutterSoftwareBackingStore2),
+		.allocation = pixels,
+		.row_bytes = row_bytes,
+		.height = height,
+		.user_data = pixels,
+		.destruction_callback = backing_store_noop, // freed in collect_backing_store_cb
+		.pixel_format = matte ? kFlutterSoftwarePixelFormatGray8 : kFlutterSoftwarePixelFormatBGRA8888,
+	};
+	return true;
+}
+
+static bool collect_backing_store_cb(const FlutterBackingStore *store, void *user_data)
+{
+	(void)user_data;
+	free(store->user_data);
+	return true;
+}
+
+static bool present_view_cb(const FlutterPresentViewInfo *info)
+{
+	/* No platform views: the app renders into a single backing-store layer */
+	for (size_t i = 0; i < info->layers_count; ++i) {
+		const FlutterLayer *layer = info->layers[i];
+		if (layer->type != kFlutterLayerContentTypeBackingStore)
+			continue;
+		const FlutterSoftwareBackingStore2 *sw = &layer->backing_store->software2;
+		return present_view(info->user_data, info->view_id, sw->allocation, sw->row_bytes, sw->height);
+	}
 	return true;
 }
 
@@ -211,77 +575,525 @@ static void log_message_cb(const char *tag, const char *msg, void *user_data)
 	blog(LOG_INFO, "[Flutter] [%s] %s", tag ? tag : "no‑tag", msg ? msg : "(null)");
 }
 
-static audio_cmd parse_audio_json(const char *data, size_t len)
+static void parse_audio_args(const cJSON *root, audio_cmd *out);
+
+static bool audio_cmd_type_from_name(const char *name, size_t len, cmd_type *out)
+{
+	static const struct {
+		const char *name;
+		cmd_type type;
+	} names[] = {{"load", CMD_LOAD}, {"play", CMD_PLAY}, {"stop", CMD_STOP}, {"volume", CMD_VOLUME}};
+
+	for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+		if (strlen(names[i].name) == len && memcmp(names[i].name, name, len) == 0) {
+			*out = names[i].type;
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool parse_audio_cmd(const cJSON *root, audio_cmd *out)
 {
-	audio_cmd out = {0};
-	cJSON *root = cJSON_ParseWithLength(data, (int)len);
-	if (!root)
-		return out;
+	memset(out, 0, sizeof(*out));
 
 	const cJSON *cmd = cJSON_GetObjectItemCaseSensitive(root, "cmd");
 	if (!cJSON_IsString(cmd) || !cmd->valuestring)
-		goto done;
-
-	if (strcmp(cmd->valuestring, "load") == 0)
-		out.type = CMD_LOAD;
-	else if (strcmp(cmd->valuestring, "play") == 0)
-		out.type = CMD_PLAY;
-	else if (strcmp(cmd->valuestring, "stop") == 0)
-		out.type = CMD_STOP;
-	else if (strcmp(cmd->valuestring, "volume") == 0)
-		out.type = CMD_VOLUME;
-	else
-		goto done;
+		return false;
 
+	if (!audio_cmd_type_from_name(cmd->valuestring, strlen(cmd->valuestring), &out->type))
+		return false;
+
+	parse_audio_args(root, out);
+	return true;
+}
+
+static void parse_audio_args(const cJSON *root, audio_cmd *out)
+{
 	const cJSON *id = cJSON_GetObjectItemCaseSensitive(root, "id");
 	if (cJSON_IsNumber(id))
-		out.id = id->valueint;
+		out->id = id->valueint;
 
 	const cJSON *vol = cJSON_GetObjectItemCaseSensitive(root, "volume");
-	out.volume = cJSON_IsNumber(vol) ? (float)vol->valuedouble : 1.f;
+	out->volume = cJSON_IsNumber(vol) ? (float)vol->valuedouble : 1.f;
 
 	const cJSON *loop = cJSON_GetObjectItemCaseSensitive(root, "loop");
-	out.loop = cJSON_IsBool(loop) ? cJSON_IsTrue(loop) : false;
+	out->loop = cJSON_IsBool(loop) ? cJSON_IsTrue(loop) : false;
 
 	const cJSON *ap = cJSON_GetObjectItemCaseSensitive(root, "absolute_path");
 	if (cJSON_IsString(ap) && ap->valuestring) {
-		strncpy(out.path, ap->valuestring, sizeof(out.path) - 1);
-		out.is_relative = false;
-		goto done;
+		strncpy(out->path, ap->valuestring, sizeof(out->path) - 1);
+		out->is_relative = false;
+		return;
 	}
 
 	const cJSON *rel = cJSON_GetObjectItemCaseSensitive(root, "asset");
 	if (cJSON_IsString(rel) && rel->valuestring) {
-		strncpy(out.path, rel->valuestring, sizeof(out.path) - 1);
-		out.is_relative = true;
+		strncpy(out->path, rel->valuestring, sizeof(out->path) - 1);
+		out->is_relative = true;
+	}
+}
+
+/* Accepts a single command object or an array of them (a batch).
+ * Returns the number of commands written to `out`; 0 if nothing valid,
+ * -1 if the batch does not fit into `cap`. */
+static int parse_audio_json(const char *data, size_t len, audio_cmd *out, int cap)
+{
+	cJSON *root = cJSON_ParseWithLength(data, len);
+	if (!root)
+		return 0;
+
+	int n = 0;
+	if (cJSON_IsArray(root)) {
+		if (cJSON_GetArraySize(root) > cap) {
+			n = -1;
+		} else {
+			const cJSON *item;
+			cJSON_ArrayForEach(item, root)
+			{
+				if (parse_audio_cmd(item, &out[n]))
+					++n;
+			}
+		}
+	} else if (cap > 0 && parse_audio_cmd(root, &out[0])) {
+		n = 1;
 	}
 
-done:
 	cJSON_Delete(root);
-	return out;
+	return n;
 }
 
-static void platform_message_cb(const FlutterPlatformMessage *msg, const void *user_data)
+//  ───────────────   StandardMethodCodec variants   ───────────────
+
+/* MethodChannel traffic starts with the method name (a codec string);
+ * JSON messages start with '{', '[' or whitespace. */
+static bool is_method_call(const FlutterPlatformMessage *msg)
 {
-	const struct flutter_source *ctx = user_data;
-	log_tid("platform_message");
+	return msg->message_size > 0 && msg->message[0] == SMC_STRING;
+}
 
-	if (strcmp(msg->channel, "obs_config") == 0) {
-		if (strncmp((const char *)msg->message, "get_dart_config", msg->message_size) == 0) {
-			FlutterEngineSendPlatformMessageResponse(ctx->engine, msg->response_handle, ctx->dart_config,
-								 (uint32_t)strlen(ctx->dart_config));
-			return;
+static void parse_audio_args_smc(const struct smc_reader *r, const struct smc_value *map, audio_cmd *out)
+{
+	struct smc_value v;
+	int64_t i;
+	double d;
+
+	if (smc_map_find(r, map, "id", &v) && smc_value_as_int(&v, &i))
+		out->id = (int)i;
+
+	out->volume = smc_map_find(r, map, "volume", &v) && smc_value_as_double(&v, &d) ? (float)d : 1.f;
+	out->loop = smc_map_find(r, map, "loop", &v) && v.type == SMC_TRUE;
+
+	if (smc_map_find(r, map, "absolute_path", &v) && smc_value_copy_string(&v, out->path, sizeof(out->path))) {
+		out->is_relative = false;
+		return;
+	}
+	if (smc_map_find(r, map, "asset", &v) && smc_value_copy_string(&v, out->path, sizeof(out->path)))
+		out->is_relative = true;
+}
+
+/* invokeMethod('play', {...}) – the method name is the command.
+ * invokeMethod('batch', [{'cmd': 'load', ...}, ...]) – a batch.  A batch
+ * that doesn't decode is dropped whole, as a broken JSON array is: nothing
+ * from it reaches the queue.  Items naming an unknown command are skipped. */
+static int parse_audio_smc(const FlutterPlatformMessage *msg, audio_cmd *out, int cap)
+{
+	struct smc_reader r;
+	struct smc_value method, args;
+	smc_reader_init(&r, msg->message, msg->message_size);
+	if (!smc_read_method_call(&r, &method, &args))
+		return 0;
+
+	if (smc_value_is_string(&method, "batch")) {
+		if (args.type != SMC_LIST)
+			return 0;
+		if ((int)args.children.count > cap)
+			return -1;
+
+		int n = 0;
+		smc_enter(&r, &args);
+		for (uint32_t i = 0; i < args.children.count; ++i) {
+			struct smc_value item, name;
+			const size_t item_pos = r.pos;
+			if (!smc_read_value(&r, &item))
+				return 0;
+			r.pos = item_pos;
+			if (!smc_skip_value(&r))
+				return 0;
+
+			memset(&out[n], 0, sizeof(out[n]));
+			if (!smc_map_find(&r, &item, "cmd", &name) || name.type != SMC_STRING ||
+			    !audio_cmd_type_from_name(name.data.ptr, name.data.count, &out[n].type))
+				continue;
+			parse_audio_args_smc(&r, &item, &out[n]);
+			++n;
+		}
+		return n;
+	}
+
+	if (cap < 1)
+		return -1;
+	memset(&out[0], 0, sizeof(out[0]));
+	if (!audio_cmd_type_from_name(method.data.ptr, method.data.count, &out[0].type))
+		return 0;
+	parse_audio_args_smc(&r, &args, &out[0]);
+	return 1;
+}
+
+/* Method-call replies must be an envelope; an empty reply reads as
+ * MissingPluginException on the Dart side. */
+static void reply_method_null(const struct flutter_source *ctx, const FlutterPlatformMessage *msg)
+{
+	static const uint8_t success_null[] = {0, SMC_NULL};
+	if (msg->response_handle)
+		g_embedder.SendPlatformMessageResponse(ctx->engine, msg->response_handle, success_null,
+							 sizeof(success_null));
+}
+
+/* {"port": "<SendPort.nativePort>"} – the port travels as a string so all 64 bits survive JSON */
+static int64_t parse_analysis_port(const char *data, size_t len)
+{
+	int64_t port = 0;
+	cJSON *root = cJSON_ParseWithLength(data, len);
+	if (!root)
+		return 0;
+
+	const cJSON *p = cJSON_GetObjectItemCaseSensitive(root, "port");
+	if (cJSON_IsString(p) && p->valuestring)
+		port = strtoll(p->valuestring, NULL, 10);
+	else if (cJSON_IsNumber(p))
+		port = (int64_t)p->valuedouble;
+
+	cJSON_Delete(root);
+	return port;
+}
+
+static bool on_config_message(void *user_data, const FlutterPlatformMessage *msg)
+{
+	struct flutter_source *ctx = user_data;
+
+	if (is_method_call(msg)) {
+		struct smc_reader r;
+		struct smc_value method, args;
+		smc_reader_init(&r, msg->message, msg->message_size);
+		if (!smc_read_method_call(&r, &method, &args) || !smc_value_is_string(&method, "get_dart_config")) {
+			reply_method_null(ctx, msg);
+			return true;
+		}
+
+		const size_t len = strlen(ctx->dart_config);
+		const size_t cap = len + 16;
+		uint8_t *reply = malloc(cap);
+		if (!reply) {
+			// Not delivered: the next config push still sends the whole text
+			g_embedder.SendPlatformMessageResponse(ctx->engine, msg->response_handle, NULL, 0);
+			return true;
+		}
+		struct smc_writer w;
+		smc_writer_init(&w, reply, cap);
+		smc_write_success_envelope(&w);
+		smc_write_string_n(&w, ctx->dart_config, len);
+		g_embedder.SendPlatformMessageResponse(ctx->engine, msg->response_handle, reply, w.pos);
+		free(reply);
+		ctx->config_delivered = true;
+		return true;
+	}
+
+	if (strncmp((const char *)msg->message, "get_dart_config", msg->message_size) != 0)
+		return false;
+
+	g_embedder.SendPlatformMessageResponse(ctx->engine, msg->response_handle, (const uint8_t *)ctx->dart_config,
+						 strlen(ctx->dart_config));
+	ctx->config_delivered = true;
+	return true;
+}
+
+/* The implicit view keeps the plain channel name, other views of a shared
+ * engine get "obs_config/<view id>". */
+static void post_config(const struct flutter_source *ctx, const char *text)
+{
+	char channel[32] = "obs_config";
+	if (ctx->view_id != 0)
+		snprintf(channel, sizeof(channel), "obs_config/%lld", (long long)ctx->view_id);
+
+	g_embedder.SendPlatformMessage(ctx->engine,
+					 &(FlutterPlatformMessage){.struct_size = sizeof(FlutterPlatformMessage),
+								   .channel = channel,
+								   .message = (const uint8_t *)text,
+								   .message_size = strlen(text)});
+}
+
+/* Platform thread.  Until Dart holds the full config it gets the whole
+ * text; afterwards only a merge patch of the keys that changed. */
+static void send_config(struct flutter_source *ctx)
+{
+	pt_mutex_lock(&ctx->config_cs);
+	char *text = bstrdup(ctx->config_latest);
+	pt_mutex_unlock(&ctx->config_cs);
+
+	if (!ctx->engine || strcmp(text, ctx->dart_config) == 0) {
+		bfree(text);
+		return;
+	}
+
+	cJSON *tree = cJSON_Parse(text);
+	if (!ctx->config_delivered || !config_patchable(ctx->dart_config_tree, tree)) {
+		post_config(ctx, text);
+		ctx->config_delivered = true;
+	} else {
+		cJSON *patch = config_merge_patch(ctx->dart_config_tree, tree);
+		if (patch) { // NULL: same document, only the formatting changed
+			char *patch_text = cJSON_PrintUnformatted(patch);
+			post_config(ctx, patch_text);
+			cJSON_free(patch_text);
+			cJSON_Delete(patch);
+		}
+	}
+
+	bfree(ctx->dart_config);
+	cJSON_Delete(ctx->dart_config_tree);
+	ctx->dart_config = text;
+	ctx->dart_config_tree = tree;
+}
+
+/* {"status": "ok", "duration": 1.25, "channels": 2} as JSON, or the same map
+ * in a success envelope for method calls (failures become error envelopes). */
+static void send_audio_reply(const struct flutter_source *ctx, const FlutterPlatformMessageResponseHandle *handle,
+			     bool method_call, const char *status, float duration, uint32_t channels)
+{
+	if (!handle)
+		return;
+
+	const bool ok = strcmp(status, "ok") == 0;
+	uint8_t buf[128];
+
+	if (method_call) {
+		struct smc_writer w;
+		smc_writer_init(&w, buf, sizeof(buf));
+		if (ok) {
+			smc_write_success_envelope(&w);
+			smc_write_map_header(&w, 3);
+			smc_write_string(&w, "status");
+			smc_write_string(&w, status);
+			smc_write_string(&w, "duration");
+			smc_write_double(&w, duration);
+			smc_write_string(&w, "channels");
+			smc_write_int(&w, channels);
+		} else {
+			smc_write_error_envelope(&w, status, "obs_audio command failed");
+		}
+		g_embedder.SendPlatformMessageResponse(ctx->engine, handle, buf, w.pos);
+		return;
+	}
+
+	const int len = snprintf((char *)buf, sizeof(buf), "{\"status\":\"%s\",\"duration\":%.3f,\"channels\":%u}",
+				 status, duration, channels);
+	g_embedder.SendPlatformMessageResponse(ctx->engine, handle, buf, (size_t)len);
+}
+
+/* Drops one outstanding count; the last one hands the reply to the platform
+ * thread through a lock-free stack.  Only the push that finds the stack
+ * empty posts a flush, so a burst of completions costs one wake-up.
+ *
+ * That post takes the worker queue's mutex on the audio tick.  The lock is
+ * held for one ring-buffer copy and the tick only feeds miniaudio (it does
+ * not render the device buffer), so this short wait is accepted. */
+static void audio_reply_release(struct flutter_source *ctx, audio_reply *reply, bool ok)
+{
+	if (!ok)
+		pt_atomic_inc(&reply->failed);
+	if (pt_atomic_dec(&reply->pending) != 0)
+		return;
+
+	audio_reply *head;
+	do {
+		head = ctx->replies_done;
+		reply->next = head;
+	} while (pt_atomic_cas_ptr((void *volatile *)&ctx->replies_done, reply, head) != head);
+
+	if (!head) {
+		const command_t cmd = {.type = CMD_FLUSH_REPLIES, .ctx = ctx};
+		queue_push(&g_queue, &cmd);
+	}
+}
+
+static audio_reply *take_audio_replies(struct flutter_source *ctx)
+{
+	audio_reply *list = pt_atomic_xchg_ptr((void *volatile *)&ctx->replies_done, NULL);
+
+	audio_reply *ordered = NULL; // the stack is LIFO, reply in completion order
+	while (list) {
+		audio_reply *next = list->next;
+		list->next = ordered;
+		ordered = list;
+		list = next;
+	}
+	return ordered;
+}
+
+/* Worker (platform) thread */
+static void flush_audio_replies(struct flutter_source *ctx)
+{
+	audio_reply *r = take_audio_replies(ctx);
+	while (r) {
+		audio_reply *next = r->next;
+		if (ctx->engine)
+			send_audio_reply(ctx, r->handle, r->method_call, r->failed ? "failed" : "ok", r->duration,
+					 r->channels);
+		free(r);
+		r = next;
+	}
+}
+
+static bool on_audio_message(void *user_data, const FlutterPlatformMessage *msg)
+{
+	struct flutter_source *ctx = user_data;
+	audio_cmd batch[AUDIO_BATCH_MAX];
+	const bool method_call = is_method_call(msg);
+
+	const int n = method_call ? parse_audio_smc(msg, batch, AUDIO_BATCH_MAX)
+				  : parse_audio_json((const char *)msg->message, msg->message_size, batch,
+						     AUDIO_BATCH_MAX);
+	if (n <= 0) {
+		if (n < 0)
+			blog(LOG_WARNING, "[FlutterSource] obs_audio batch exceeds %d commands, dropped",
+			     AUDIO_BATCH_MAX);
+		send_audio_reply(ctx, msg->response_handle, method_call, "invalid", 0.f, 0);
+		return true;
+	}
+
+	audio_reply *reply = NULL;
+	if (msg->response_handle) {
+		reply = calloc(1, sizeof(*reply));
+		if (!reply) {
+			send_audio_reply(ctx, msg->response_handle, method_call, "out_of_memory", 0.f, 0);
+			return true;
+		}
+		reply->handle = msg->response_handle;
+		reply->method_call = method_call;
+		reply->pending = n + 1; // the extra count is released below, once the batch is queued
+		for (int i = 0; i < n; ++i)
+			batch[i].reply = reply;
+	}
+
+	if (!push_batch(&ctx->cmdq, batch, (uint32_t)n)) {
+		blog(LOG_WARNING, "[FlutterSource] audio queue full, dropped %d command(s)", n);
+		send_audio_reply(ctx, msg->response_handle, method_call, "queue_full", 0.f, 0);
+		free(reply);
+		return true;
+	}
+
+	// Replied later from flush_audio_replies(), once the audio thread is done
+	if (reply)
+		audio_reply_release(ctx, reply, true);
+	return true;
+}
+
+static bool on_analysis_message(void *user_data, const FlutterPlatformMessage *msg)
+{
+	struct flutter_source *ctx = user_data;
+
+	if (is_method_call(msg)) {
+		/* invokeMethod('listen', port) or invokeMethod('listen', {'port': port}) */
+		struct smc_reader r;
+		struct smc_value method, args, v;
+		int64_t port = 0;
+		smc_reader_init(&r, msg->message, msg->message_size);
+		if (smc_read_method_call(&r, &method, &args)) {
+			if (!smc_value_as_int(&args, &port) && smc_map_find(&r, &args, "port", &v))
+				smc_value_as_int(&v, &port);
+		}
+		pt_atomic_xchg64(&ctx->analysis_port, port);
+		reply_method_null(ctx, msg);
+		return true;
+	}
+
+	const int64_t port = parse_analysis_port((const char *)msg->message, msg->message_size);
+	pt_atomic_xchg64(&ctx->analysis_port, port);
+	return false;
+}
+
+/* Hands the Dart side the handle for the obs_flutter_* FFI entry points
+ * ("handle"), and the path to open the plug-in by ("library"). */
+static bool on_ffi_message(void *user_data, const FlutterPlatformMessage *msg)
+{
+	const struct flutter_source *ctx = user_data;
+	if (!msg->response_handle)
+		return true;
+
+	if (is_method_call(msg)) {
+		struct smc_reader r;
+		struct smc_value method, args;
+		char library[MAX_PATH];
+		smc_reader_init(&r, msg->message, msg->message_size);
+		const bool want_library = smc_read_method_call(&r, &method, &args) &&
+					  smc_value_is_string(&method, "library");
+
+		uint8_t reply[MAX_PATH + 16];
+		struct smc_writer w;
+		smc_writer_init(&w, reply, sizeof(reply));
+		if (!want_library) {
+			smc_write_success_envelope(&w);
+			smc_write_int(&w, ctx->ffi_handle);
+		} else if (pt_module_path(library, sizeof(library))) {
+			smc_write_success_envelope(&w);
+			smc_write_string(&w, library);
+		} else {
+			smc_write_error_envelope(&w, "unavailable", "plug-in path unknown");
 		}
+		g_embedder.SendPlatformMessageResponse(ctx->engine, msg->response_handle, reply, w.pos);
+	} else {
+		char reply[32];
+		const int n = snprintf(reply, sizeof(reply), "%lld", (long long)ctx->ffi_handle);
+		g_embedder.SendPlatformMessageResponse(ctx->engine, msg->response_handle, (const uint8_t *)reply,
+							 (size_t)n);
 	}
+	return true;
+}
+
+static const struct {
+	const char *name;
+	channel_handler_fn handler;
+} g_view_channels[] = {
+	{"obs_config", on_config_message},
+	{"obs_audio", on_audio_message},
+	{"obs_analysis", on_analysis_message},
+	{"obs_ffi", on_ffi_message},
+};
 
-	if (strcmp(msg->channel, "obs_audio") == 0) {
-		const audio_cmd cmd = parse_audio_json((const char *)msg->message, msg->message_size);
-		push(&g_cmdq, &cmd);
+/* Every view gets "<channel>/<view id>"; the implicit view also owns the
+ * plain names, so single-view apps need no changes.  Passing NULL as
+ * `ctx` unbinds the view's channels. */
+static void bind_view_channels(struct flutter_host *host, FlutterViewId view_id, struct flutter_source *ctx)
+{
+	for (size_t i = 0; i < sizeof(g_view_channels) / sizeof(g_view_channels[0]); ++i) {
+		char name[64];
+		snprintf(name, sizeof(name), "%s/%lld", g_view_channels[i].name, (long long)view_id);
+		channel_registry_add(&host->channels, name, ctx ? g_view_channels[i].handler : NULL, ctx);
+		if (view_id == 0)
+			channel_registry_add(&host->channels, g_view_channels[i].name,
+					     ctx ? g_view_channels[i].handler : NULL, ctx);
 	}
+}
+
+static void platform_message_cb(const FlutterPlatformMessage *msg, const void *user_data)
+{
+	struct flutter_host *host = (struct flutter_host *)user_data;
+
+	const struct channel_entry *e;
+
+	// Any cJSON tree built by a handler lives in the thread's arena until the reply is out
+	json_arena_begin();
+	const bool replied = channel_registry_dispatch(&host->channels, msg, &e);
+	json_arena_end();
+	if (e)
+		((struct flutter_source *)e->user_data)->platform_messages++;
+	if (replied)
+		return;
 
 	// Echo an empty success reply so Dart side can await the call safely
 	if (msg->response_handle) {
-		FlutterEngineSendPlatformMessageResponse(ctx->engine, msg->response_handle, NULL, 0);
+		g_embedder.SendPlatformMessageResponse(host->engine, msg->response_handle, NULL, 0);
 	}
 }
 
@@ -291,132 +1103,478 @@ static void platform_message_cb(const FlutterPlatformMessage *msg, const void *u
 
 static bool runs_on_worker_thread(const void *user_data)
 {
-	const struct flutter_source *ctx = user_data;
-	return GetCurrentThreadId() == ctx->engine_tid;
+	const struct flutter_host *host = user_data;
+	return pt_thread_id() == host->engine_tid;
 }
 
 static bool post_task_to_worker(const FlutterTask task, const uint64_t target_time_ns, void *user_data)
 {
-	struct flutter_source *ctx = user_data;
 	const command_t cmd = {
 		.type = CMD_RUN_ENGINE_TASK,
-		.ctx = ctx,
+		.host = user_data,
 		.task = task,
 		.target_time_ns = target_time_ns,
-		.done_event = NULL,
 	};
 	queue_push(&g_queue, &cmd);
 	return true;
 }
 
+/* UI thread.  The baton waits for the next OBS frame in host_return_vsync();
+ * the engine only ever has one outstanding. */
+static void vsync_cb(void *user_data, intptr_t baton)
+{
+	struct flutter_host *host = user_data;
+	pt_atomic_xchg64(&host->vsync_baton, (int64_t)baton);
+}
+
+/* Graphics thread, from every view's video_tick.  Frames start on OBS's
+ * frame clock, every `divider`th tick when the governor throttles (the least
+ * throttled view wins on a shared engine).  Handing the baton back here
+ * keeps it out of the worker queue, where it would wait behind tasks. */
+static void host_return_vsync(struct flutter_host *host, FlutterEngine engine)
+{
+	if (!host->vsync_baton)
+		return;
+
+	long divider = 0;
+	pt_rwlock_read_lock(&host->views_lock);
+	for (int i = 0; i < HOST_MAX_VIEWS; ++i) {
+		const struct flutter_source *view = host->views[i];
+		if (view && (!divider || view->governor.divider < divider))
+			divider = view->governor.divider;
+	}
+	pt_rwlock_read_unlock(&host->views_lock);
+
+	const uint64_t interval = obs_get_frame_interval_ns();
+	const uint64_t now = (g_embedder.GetCurrentTime)();
+	if (now + interval / 2 < host->next_vsync_ns) // half an interval absorbs tick jitter
+		return;
+
+	const intptr_t baton = (intptr_t)pt_atomic_xchg64(&host->vsync_baton, 0);
+	if (!baton)
+		return;
+	const uint64_t period = (interval ? interval : 16666667ULL) * (uint64_t)(divider > 1 ? divider : 1);
+	host->next_vsync_ns = now + period;
+	g_embedder.OnVsync(engine, baton, now, now + period);
+}
+
+//  ────────────────────────────────────────────────────────────────
+//  Module settings (settings.json in the module config directory)
+//  ────────────────────────────────────────────────────────────────
+
+/* Process-wide knobs that have no place in per-source properties:
+ *   {"warm_engines": 0, "warm_idle_timeout_s": 300,
+ *    "persistent_cache_read_only": false, "cache_warmup": false,
+ *    "engine_library": "flutter_engine.dll", "threads": {...}}
+ * ("threads" is described in thread-sched.h).  Read when the first source
+ * starts the worker thread. */
+static struct {
+	int warm_engines;
+	uint64_t warm_idle_ns;
+	bool cache_read_only; // use the persistent cache without writing to it
+	bool cache_warmup;    // tell the app to play its warm-up script
+	char engine_library[MAX_PATH]; // UTF-8, "" = FLUTTER_ENGINE_LIBRARY next to the plug-in
+} g_settings;
+
+static void module_settings_load(void)
+{
+	char *path = obs_module_config_path("settings.json");
+	obs_data_t *cfg = path ? obs_data_create_from_json_file_safe(path, "bak") : NULL;
+	bfree(path);
+	if (!cfg)
+		cfg = obs_data_create();
+
+	obs_data_set_default_int(cfg, "warm_engines", 0); // opt-in: each one holds an engine's memory
+	obs_data_set_default_int(cfg, "warm_idle_timeout_s", 300);
+	obs_data_set_default_bool(cfg, "persistent_cache_read_only", false);
+	obs_data_set_default_bool(cfg, "cache_warmup", false);
+	const long long size = obs_data_get_int(cfg, "warm_engines");
+	const long long idle_s = obs_data_get_int(cfg, "warm_idle_timeout_s");
+	g_settings.warm_engines = size < 0 ? 0 : size > 8 ? 8 : (int)size;
+	g_settings.warm_idle_ns = (uint64_t)(idle_s < 1 ? 1 : idle_s) * 1000000000ULL;
+	g_settings.cache_warmup = obs_data_get_bool(cfg, "cache_warmup");
+	g_settings.cache_read_only = obs_data_get_bool(cfg, "persistent_cache_read_only") && !g_settings.cache_warmup;
+	snprintf(g_settings.engine_library, sizeof(g_settings.engine_library), "%s",
+		 obs_data_get_string(cfg, "engine_library"));
+	obs_data_t *threads = obs_data_get_obj(cfg, "threads");
+	thread_sched_load(threads);
+	obs_data_release(threads);
+	obs_data_release(cfg);
+}
+
 //  ────────────────────────────────────────────────────────────────
 //  Worker thread main procedure
 //  ────────────────────────────────────────────────────────────────
 
-static DWORD WINAPI worker_thread_fn(LPVOID param)
+static void worker_thread_fn(void *param)
 {
 	(void)param;
-	g_worker_tid = GetCurrentThreadId();
 	log_tid("worker_started");
+	thread_sched_apply(THREAD_CLASS_WORKER);
 
 	command_t cmd;
 	while (queue_pop(&g_queue, &cmd)) {
 		switch (cmd.type) {
 		case CMD_CREATE_ENGINE:
-			engine_init(cmd.ctx);
+			host_attach(cmd.ctx);
 			break;
 
 		case CMD_DESTROY_ENGINE:
-			engine_shutdown(cmd.ctx);
+			host_detach(cmd.ctx);
 			break;
 
 		case CMD_RUN_ENGINE_TASK: {
-			uint64_t now = FlutterEngineGetCurrentTime();
+			uint64_t now = (g_embedder.GetCurrentTime)(); // windows.h has a GetCurrentTime() macro
 			if (now < cmd.target_time_ns) {
-				DWORD sleep_ms = (DWORD)((cmd.target_time_ns - now) / 1000000ULL);
+				const uint32_t sleep_ms = (uint32_t)((cmd.target_time_ns - now) / 1000000ULL);
 				if (sleep_ms) {
 					if (sleep_ms > 16) {
 						blog(LOG_WARNING,
-						     "[FlutterSource] Delayed task execution for %lu ms (now=%llu, target=%llu)",
-						     sleep_ms, now, cmd.target_time_ns);
+						     "[FlutterSource] Delayed task execution for %u ms (now=%llu, target=%llu)",
+						     sleep_ms, (unsigned long long)now,
+						     (unsigned long long)cmd.target_time_ns);
 					}
-					Sleep(sleep_ms);
+					os_sleep_ms(sleep_ms);
 				}
 			}
-			if (cmd.ctx && cmd.ctx->engine)
-				FlutterEngineRunTask(cmd.ctx->engine, &cmd.task);
+			if (cmd.host && cmd.host->engine)
+				g_embedder.RunTask(cmd.host->engine, &cmd.task);
 			break;
 		}
 
+		case CMD_FLUSH_REPLIES:
+			flush_audio_replies(cmd.ctx);
+			break;
+
+		case CMD_SEND_CONFIG:
+			send_config(cmd.ctx);
+			break;
+
+		case CMD_FREE_HOST:
+			host_free(cmd.host);
+			break;
+
+		case CMD_FILL_POOL:
+			warm_pool_fill();
+			break;
+
+		case CMD_TRIM_POOL:
+			warm_pool_trim();
+			break;
+
+		case CMD_VIEW_REFUSED:
+			host_view_refused(cmd.ctx);
+			break;
+
 		case CMD_EXIT:
-			if (cmd.done_event)
-				SetEvent(cmd.done_event);
-			return 0;
+			warm_pool_drain();
+			json_arena_thread_release();
+			if (cmd.done)
+				pt_sem_post(cmd.done);
+			return;
 		}
-		if (cmd.done_event)
-			SetEvent(cmd.done_event);
+		if (cmd.done)
+			pt_sem_post(cmd.done);
 	}
-	return 0;
 }
 
 static void ensure_worker_thread(void)
 {
-	if (!g_worker_thread) {
+	if (!g_worker_running) {
+		module_settings_load();
+		embedder_load(g_settings.engine_library); // sources stay empty without it
 		queue_init(&g_queue);
-		g_worker_thread = CreateThread(NULL, 0, worker_thread_fn, NULL, 0, &g_worker_tid);
+		g_worker_running = pt_thread_create(&g_worker_thread, worker_thread_fn, NULL);
 	}
 }
 
 static void stop_worker_thread(void)
 {
-	if (g_worker_thread) {
-		HANDLE done = CreateEvent(NULL, FALSE, FALSE, NULL);
-		command_t cmd = {.type = CMD_EXIT, .done_event = done};
+	if (g_worker_running) {
+		const command_t cmd = {.type = CMD_EXIT};
 		queue_push(&g_queue, &cmd);
-		WaitForSingleObject(done, INFINITE);
-		CloseHandle(done);
-		CloseHandle(g_worker_thread);
+		pt_thread_join(g_worker_thread);
 		queue_destroy(&g_queue);
-		g_worker_thread = NULL;
+		g_worker_running = false;
 	}
 }
 
 //  ────────────────────────────────────────────────────────────────
-//  Helpers: locate assets next to the plug‑in DLL
+//  Helpers: locate assets next to the plug‑in binary
 //  ────────────────────────────────────────────────────────────────
 
-static void locate_assets(wchar_t *assets_path, wchar_t *icu_path, wchar_t *aot_path)
+#define BUNDLE_DIR PT_PATH_SEP "flutter_template" PT_PATH_SEP
+
+/* UTF-8 paths of the app bundle shipped next to the plug-in. */
+static void locate_bundle(char *assets, char *icu, char *aot)
+{
+	char dir[MAX_PATH];
+	if (!pt_module_dir(dir, sizeof(dir)))
+		dir[0] = '\0';
+
+	snprintf(assets, MAX_PATH, "%s" BUNDLE_DIR "flutter_assets", dir);
+	snprintf(icu, MAX_PATH, "%s" BUNDLE_DIR "icudtl.dat", dir);
+	snprintf(aot, MAX_PATH, "%s" BUNDLE_DIR "app.so", dir);
+}
+
+//  ────────────────────────────────────────────────────────────────
+//  Sound preloading (decoded in parallel while the engine starts)
+//  ────────────────────────────────────────────────────────────────
+
+#define PRELOAD_MAX_THREADS 8
+
+typedef struct {
+	int id;
+	char path[MAX_PATH]; // resolved, UTF-8
+	ma_sound *sound;     // NULL if decoding failed
+} preload_job;
+
+typedef struct preload_pool {
+	struct flutter_source *ctx;
+	preload_job *jobs;
+	int count;
+	volatile long next;    // next job index to claim
+	volatile long running; // decoder threads not yet done
+	pt_thread threads[PRELOAD_MAX_THREADS];
+	int thread_count;
+	uint64_t start_ns;
+} preload_pool;
+
+static void resolve_sound_path(const struct flutter_source *ctx, const char *path, bool is_relative, char *out,
+			       size_t cap)
+{
+	if (is_relative)
+		snprintf(out, cap, "%s" PT_PATH_SEP "%s", ctx->assets_dir, path);
+	else
+		snprintf(out, cap, "%s", path);
+}
+
+static void preload_decode(preload_pool *pool)
 {
-	HMODULE self = NULL;
-	GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
-			   (LPCWSTR)&locate_assets, &self);
+	for (;;) {
+		const long i = pt_atomic_inc(&pool->next) - 1;
+		if (i >= pool->count)
+			break;
 
-	wchar_t dll_folder[MAX_PATH];
-	GetModuleFileNameW(self, dll_folder, MAX_PATH);
-	PathRemoveFileSpecW(dll_folder);
+		preload_job *job = &pool->jobs[i];
+		job->sound = malloc(sizeof(ma_sound));
+		const ma_result res = ma_sound_init_from_file(&pool->ctx->ma, job->path, MA_SOUND_FLAG_DECODE, NULL,
+							      NULL, job->sound);
+		if (res != MA_SUCCESS) {
+			blog(LOG_ERROR, "[FlutterSource] preload: can't load %s (ma err %d)", job->path, res);
+			free(job->sound);
+			job->sound = NULL;
+		}
+	}
+}
 
-	wsprintfW(assets_path, L"%s\\flutter_template\\flutter_assets", dll_folder);
-	wsprintfW(icu_path, L"%s\\flutter_template\\icudtl.dat", dll_folder);
-	wsprintfW(aot_path, L"%s\\flutter_template\\app.so", dll_folder);
+static void preload_thread_fn(void *param)
+{
+	preload_pool *pool = param;
+	thread_sched_apply(THREAD_CLASS_BACKGROUND);
+	preload_decode(pool);
+	pt_atomic_dec(&pool->running);
+}
+
+/* Manifest entries look like audio "load" commands: {"id": 3, "asset": "sounds/a.wav"}
+ * or {"id": 3, "absolute_path": "C:\\..."}. */
+static void preload_collect(preload_pool *pool, const cJSON *list)
+{
+	const cJSON *item;
+	cJSON_ArrayForEach(item, list)
+	{
+		audio_cmd c = {.type = CMD_LOAD};
+		parse_audio_args(item, &c);
+		if (c.id < 0 || c.id >= 256 || !c.path[0])
+			continue;
+
+		preload_job *job = &pool->jobs[pool->count++];
+		job->id = c.id;
+		resolve_sound_path(pool->ctx, c.path, c.is_relative, job->path, sizeof(job->path));
+		if (pool->count == 256)
+			return;
+	}
+}
+
+/* Reads the manifest from dart_config["preload"] and <flutter_assets>/preload.json
+ * and starts decoding in the background.  The pool is published in
+ * ctx->preload for audio_tick() to install. */
+static void preload_start(struct flutter_source *ctx)
+{
+	if (ctx->preload_started) // moved to another engine, the sounds come along
+		return;
+	ctx->preload_started = true;
+
+	preload_pool *pool = calloc(1, sizeof(*pool));
+	preload_job *jobs = pool ? calloc(256, sizeof(preload_job)) : NULL;
+	if (!jobs) {
+		// Without a pool the audio thread never waits on a manifest, so
+		// sounds just load on first play as they did before preloading.
+		blog(LOG_WARNING, "[FlutterSource] Out of memory, skipping audio preload");
+		free(pool);
+		return;
+	}
+	pool->ctx = ctx;
+	pool->jobs = jobs;
+
+	const cJSON *list = cJSON_GetObjectItemCaseSensitive(ctx->dart_config_tree, "preload");
+	if (cJSON_IsArray(list))
+		preload_collect(pool, list);
+
+	char manifest_path[MAX_PATH];
+	snprintf(manifest_path, sizeof(manifest_path), "%s" PT_PATH_SEP "preload.json", ctx->assets_dir);
+	char *text = os_file_exists(manifest_path) ? os_quick_read_utf8_file(manifest_path) : NULL;
+	if (text) {
+		cJSON *manifest = cJSON_Parse(text);
+		list = cJSON_IsArray(manifest) ? manifest : cJSON_GetObjectItemCaseSensitive(manifest, "preload");
+		if (cJSON_IsArray(list) && pool->count < 256)
+			preload_collect(pool, list);
+		cJSON_Delete(manifest);
+		bfree(text);
+	}
+
+	if (!pool->count) {
+		free(pool->jobs);
+		free(pool);
+		return;
+	}
+
+	int threads = os_get_logical_cores();
+	if (threads > PRELOAD_MAX_THREADS)
+		threads = PRELOAD_MAX_THREADS;
+	if (threads > pool->count)
+		threads = pool->count;
+	if (threads < 1)
+		threads = 1;
+
+	pool->start_ns = os_gettime_ns();
+	pool->running = threads;
+	for (int i = 0; i < threads; ++i) {
+		if (pt_thread_create(&pool->threads[pool->thread_count], preload_thread_fn, pool))
+			pool->thread_count++;
+		else
+			pt_atomic_dec(&pool->running);
+	}
+	if (!pool->thread_count)
+		preload_decode(pool); // decode inline rather than not at all
+	pt_atomic_xchg_ptr((void *volatile *)&ctx->preload, pool);
+}
+
+/* Joins the decoders and makes the sounds resident.  Runs on the audio
+ * thread, which holds every audio command back until the manifest is in,
+ * so the slots can be filled directly.  Returns false while decoding is
+ * still going on, unless `wait` is set (teardown). */
+static bool preload_finish(struct flutter_source *ctx, bool wait)
+{
+	preload_pool *pool = ctx->preload;
+	if (!pool)
+		return true;
+	if (pool->running && !wait)
+		return false;
+
+	for (int i = 0; i < pool->thread_count; ++i)
+		pt_thread_join(pool->threads[i]);
+
+	int loaded = 0;
+	for (int i = 0; i < pool->count; ++i) {
+		preload_job *job = &pool->jobs[i];
+		if (!job->sound)
+			continue;
+		if (ctx->sounds[job->id]) {
+			ma_sound_uninit(ctx->sounds[job->id]);
+			free(ctx->sounds[job->id]);
+		}
+		ctx->sounds[job->id] = job->sound;
+		++loaded;
+	}
+
+	blog(LOG_INFO, "[FlutterSource] preloaded %d/%d sound(s) on %d thread(s) in %.1f ms", loaded, pool->count,
+	     pool->thread_count ? pool->thread_count : 1, (double)(os_gettime_ns() - pool->start_ns) / 1000000.0);
+
+	free(pool->jobs);
+	free(pool);
+	ctx->preload = NULL;
+	return true;
 }
 
 //  ────────────────────────────────────────────────────────────────
 //  Flutter engine lifecycle (runs on worker thread)
 //  ────────────────────────────────────────────────────────────────
 
-static void engine_init(struct flutter_source *ctx)
+static struct flutter_host *g_hosts; // worker thread
+
+/* The render scale (and the governor's on top of it) shrinks the physical
+ * size and the pixel ratio together: the layout stays the same,
+ * source_render stretches the smaller frame to the output size. */
+static void view_metrics(const struct flutter_source *ctx, FlutterWindowMetricsEvent *wm)
 {
-	log_tid("engine_init");
-	ctx->engine_tid = GetCurrentThreadId();
+	const uint32_t scale_pct = ctx->render_scale_pct * (uint32_t)ctx->governor.scale_pct / 100;
+	const size_t width = (size_t)ctx->width * scale_pct / 100;
+	const size_t height = (size_t)ctx->height * scale_pct / 100;
+	*wm = (FlutterWindowMetricsEvent){
+		.struct_size = sizeof(*wm),
+		.width = width ? width : 1,
+		.height = height ? height : 1,
+		.pixel_ratio = (float)(ctx->pixel_ratio_pct * scale_pct) / 10000.0f,
+		.view_id = ctx->view_id,
+	};
+}
 
-	// Resolve asset paths (UTF‑8)
-	wchar_t assets_w[MAX_PATH], icu_w[MAX_PATH], aot_w[MAX_PATH];
-	locate_assets(assets_w, icu_w, aot_w);
+/* <module config>/cache/<bundle hash>: one persistent cache per app bundle,
+ * so rebuilding into another directory never reuses stale entries. */
+static bool cache_dir_for_bundle(const char *assets, char *out, size_t cap)
+{
+	uint64_t h = 0xcbf29ce484222325ULL; // FNV-1a
+	for (const char *c = assets; *c; ++c)
+		h = (h ^ (uint8_t)*c) * 0x100000001b3ULL;
+
+	char name[64];
+	snprintf(name, sizeof(name), "cache/%016llx", (unsigned long long)h);
+	char *path = obs_module_config_path(name);
+	if (!path)
+		return false;
 
-	char assets[MAX_PATH], icu[MAX_PATH], aot[MAX_PATH];
-	WideCharToMultiByte(CP_UTF8, 0, assets_w, -1, assets, MAX_PATH, NULL, NULL);
-	WideCharToMultiByte(CP_UTF8, 0, icu_w, -1, icu, MAX_PATH, NULL, NULL);
-	WideCharToMultiByte(CP_UTF8, 0, aot_w, -1, aot, MAX_PATH, NULL, NULL);
+	const bool ok = (g_settings.cache_read_only || os_mkdirs(path) != MKDIR_ERROR) && strlen(path) < cap;
+	if (ok)
+		strcpy(out, path);
+	bfree(path);
+	return ok;
+}
+
+/* Publishes `ctx` as view `view_id`: frames for it are routed to its
+ * buffer and its channels are bound. */
+static void host_add_view(struct flutter_host *host, struct flutter_source *ctx, FlutterViewId view_id)
+{
+	ctx->host = host;
+	ctx->view_id = view_id;
+	strncpy(ctx->assets_dir, host->assets_dir, sizeof(ctx->assets_dir) - 1);
+
+	pt_rwlock_write_lock(&host->views_lock);
+	host->views[view_id] = ctx;
+	pt_rwlock_write_unlock(&host->views_lock);
+	pt_atomic_inc(&host->view_count);
+
+	bind_view_channels(host, view_id, ctx);
+}
+
+/* Creates a host and initializes its engine without running it: assets,
+ * ICU and AOT data are loaded, the Dart isolate doesn't exist yet.  On
+ * failure host->engine stays NULL.  `matte` hosts render through the
+ * compositor even with a single view. */
+static struct flutter_host *host_init(bool shared, bool matte)
+{
+	struct flutter_host *host = bzalloc(sizeof(*host));
+	host->shared = shared;
+	host->engine_tid = pt_thread_id();
+	pt_rwlock_init(&host->views_lock);
+	pt_mutex_init(&host->lifecycle_cs);
+	channel_registry_init(&host->channels);
+	if (!g_embedder.Initialize)
+		return host; // engine library missing, logged by embedder_load()
+
+	// Resolve asset paths (UTF‑8)
+	char icu[MAX_PATH], aot[MAX_PATH];
+	locate_bundle(host->assets_dir, icu, aot);
 
 	// Software renderer configuration
 	FlutterSoftwareRendererConfig sw = {
@@ -429,67 +1587,411 @@ static void engine_init(struct flutter_source *ctx)
 	};
 
 	// Custom platform task‑runner (this worker thread)
-	ctx->platform_runner_desc = (FlutterTaskRunnerDescription){
+	host->platform_runner_desc = (FlutterTaskRunnerDescription){
 		.struct_size = sizeof(FlutterTaskRunnerDescription),
-		.user_data = ctx,
+		.user_data = host,
 		.runs_task_on_current_thread_callback = runs_on_worker_thread,
 		.post_task_callback = post_task_to_worker,
 	};
-	ctx->custom_runners = (FlutterCustomTaskRunners){
+	host->custom_runners = (FlutterCustomTaskRunners){
 		.struct_size = sizeof(FlutterCustomTaskRunners),
-		.platform_task_runner = &ctx->platform_runner_desc,
+		.platform_task_runner = &host->platform_runner_desc,
+		.thread_priority_setter = thread_sched_priority_setter, // UI, raster and IO threads as created
 	};
 
-	// Project arguments
-	static const char *argv[] = {"obs_flutter", "--verbose-logging"};
+	// Project arguments; warm-up runs also capture SkSL for GPU renderers
+	static const char *argv[] = {"obs_flutter", "--verbose-logging", "--cache-sksl"};
+	static const char *warmup_argv[] = {"--obs-cache-warmup"};
 	FlutterProjectArgs args = {
 		.struct_size = sizeof(FlutterProjectArgs),
-		.assets_path = assets,
+		.assets_path = host->assets_dir,
 		.icu_data_path = icu,
-		.command_line_argc = (int)(sizeof(argv) / sizeof(argv[0])),
+		.command_line_argc = (int)(sizeof(argv) / sizeof(argv[0])) - (g_settings.cache_warmup ? 0 : 1),
 		.command_line_argv = argv,
 		.log_message_callback = log_message_cb,
 		.platform_message_callback = platform_message_cb,
-		.custom_task_runners = &ctx->custom_runners,
+		.vsync_callback = vsync_cb,
+		.custom_task_runners = &host->custom_runners,
 	};
 
-	strncpy(ctx->assets_dir, assets, sizeof(ctx->assets_dir) - 1);
+	// Shader and raster caches survive OBS restarts
+	char cache[MAX_PATH];
+	if (cache_dir_for_bundle(host->assets_dir, cache, sizeof(cache))) {
+		args.persistent_cache_path = cache;
+		args.is_persistent_cache_read_only = g_settings.cache_read_only;
+	}
 
-	// Optional AOT data (ignored if file missing)
-	FlutterEngineAOTDataSource aot_src = {
-		.type = kFlutterEngineAOTDataSourceTypeElfPath,
-		.elf_path = aot,
-	};
-	if (FlutterEngineCreateAOTData(&aot_src, &ctx->aot_data) == kSuccess)
-		args.aot_data = ctx->aot_data;
+	/* The app sees the flag in main(List<String> args) and plays its
+	 * scripted run so that every animation is rendered once. */
+	if (g_settings.cache_warmup) {
+		args.dart_entrypoint_argc = 1;
+		args.dart_entrypoint_argv = warmup_argv;
+	}
 
-	// Run engine
-	FlutterEngineResult res = FlutterEngineRun(FLUTTER_ENGINE_VERSION, &renderer, &args, ctx, &ctx->engine);
+	// Multi-view needs a compositor: every view presents its own backing store
+	if (shared || matte) {
+		host->compositor = (FlutterCompositor){
+			.struct_size = sizeof(FlutterCompositor),
+			.user_data = host,
+			.create_backing_store_callback = create_backing_store_cb,
+			.collect_backing_store_callback = collect_backing_store_cb,
+			.present_view_callback = present_view_cb,
+		};
+		args.compositor = &host->compositor;
+	}
+
+	// Optional AOT data (ignored if file missing), mapped once per process
+	host->aot_data = aot_cache_acquire(aot);
+	args.aot_data = host->aot_data;
+
+	const FlutterEngineResult res =
+		g_embedder.Initialize(FLUTTER_ENGINE_VERSION, &renderer, &args, host, &host->engine);
 	if (res != kSuccess) {
-		blog(LOG_ERROR, "FlutterEngineRun failed (%d)", res);
+		blog(LOG_ERROR, "FlutterEngineInitialize failed (%d)", res);
+		host->engine = NULL;
+	}
+	return host;
+}
+
+/* Engine teardown shared by running and warm hosts.  The host itself is
+ * freed separately: tasks posted before the shutdown may still name it. */
+static void host_shutdown(struct flutter_host *host)
+{
+	if (host->engine) {
+		g_embedder.Shutdown(host->engine);
+		host->engine = NULL;
+	}
+	pt_atomic_xchg64(&host->vsync_baton, 0); // belonged to that engine
+	aot_cache_release(host->aot_data);
+	host->aot_data = NULL;
+	channel_registry_log_stats(&host->channels);
+	channel_registry_free(&host->channels);
+}
+
+/* Runs an initialized host with `ctx` as its implicit view. */
+static void host_run(struct flutter_host *host, struct flutter_source *ctx)
+{
+	// The first source is the implicit view
+	host_add_view(host, ctx, 0);
+
+	// Decode the sound manifest while the engine boots
+	preload_start(ctx);
+
+	if (!host->engine)
+		return;
+
+	// The isolate boots on the engine's own UI thread after this returns
+	const uint64_t run_ns = os_gettime_ns();
+	const FlutterEngineResult res = g_embedder.RunInitialized(host->engine);
+	if (res != kSuccess) {
+		blog(LOG_ERROR, "FlutterEngineRunInitialized failed (%d)", res);
+		g_embedder.Shutdown(host->engine);
+		host->engine = NULL;
 		return;
 	}
+	pt_atomic_xchg_ptr((void *volatile *)&ctx->engine, host->engine); // before reading the size apply_resize may change
+
+	// Also reaches the Dart worker pool, which the priority setter never sees
+	if (thread_sched_engine_configured())
+		g_embedder.PostCallbackOnAllNativeThreads(host->engine, thread_sched_native_thread_cb, NULL);
 
 	// Initial window metrics
-	FlutterWindowMetricsEvent wm = {
-		.struct_size = sizeof(wm),
-		.width = ctx->width,
-		.height = ctx->height,
-		.pixel_ratio = (float)(ctx->pixel_ratio_pct) / 100.0f,
-	};
+	FlutterWindowMetricsEvent wm;
+	view_metrics(ctx, &wm);
+	g_embedder.SendWindowMetricsEvent(host->engine, &wm);
+	g_embedder.ScheduleFrame(host->engine);
+	blog(LOG_INFO, "Flutter engine started%s in %.1f ms", host->shared ? " (shared)" : "",
+	     (double)(os_gettime_ns() - run_ns) / 1e6);
+}
+
+//  ────────────────────────────────────────────────────────────────
+//  Warm engine pool (worker thread)
+//  ────────────────────────────────────────────────────────────────
+
+/* Initialized engines kept ready so that a new source only pays for
+ * FlutterEngineRunInitialized.  Engines nobody claims within the idle
+ * timeout are shut down; the pool is refilled whenever a source starts an
+ * engine of its own. */
+static struct {
+	struct flutter_host *hosts; // linked through next
+	int count;
+	bool shared; // flavour to prewarm: that of the last engine claimed
+	pt_timer *timer;
+	uint64_t hits, misses, expired;
+} g_warm;
+
+static void warm_timer_cb(void *param)
+{
+	const command_t cmd = {.type = CMD_TRIM_POOL};
+	queue_push(&g_queue, &cmd);
+}
 
-	FlutterEngineSendWindowMetricsEvent(ctx->engine, &wm);
-	FlutterEngineScheduleFrame(ctx->engine);
-	blog(LOG_INFO, "Flutter engine started");
+static void warm_timer_stop(void)
+{
+	pt_timer_stop(g_warm.timer);
+	g_warm.timer = NULL;
 }
 
-static void engine_shutdown(struct flutter_source *ctx)
+static struct flutter_host *warm_pool_claim(bool shared)
 {
-	log_tid("engine_shutdown");
-	if (ctx->engine) {
-		FlutterEngineShutdown(ctx->engine);
-		ctx->engine = NULL;
+	char assets[MAX_PATH], icu[MAX_PATH], aot[MAX_PATH];
+	locate_bundle(assets, icu, aot);
+
+	g_warm.shared = shared;
+	for (struct flutter_host **it = &g_warm.hosts; *it; it = &(*it)->next) {
+		struct flutter_host *host = *it;
+		if (host->shared == shared && strcmp(host->assets_dir, assets) == 0) {
+			*it = host->next;
+			host->next = NULL;
+			g_warm.count--;
+			g_warm.hits++;
+			return host;
+		}
 	}
+	g_warm.misses++;
+	return NULL;
+}
+
+static void warm_pool_fill(void)
+{
+	while (g_warm.count < g_settings.warm_engines) {
+		struct flutter_host *host = host_init(g_warm.shared, false);
+		if (!host->engine) {
+			host_shutdown(host);
+			host_free(host);
+			break;
+		}
+		host->warm_since_ns = os_gettime_ns();
+		host->next = g_warm.hosts;
+		g_warm.hosts = host;
+		g_warm.count++;
+	}
+
+	if (g_warm.count && !g_warm.timer) {
+		const uint32_t period_ms = (uint32_t)(g_settings.warm_idle_ns / 2000000ULL);
+		g_warm.timer = pt_timer_start(period_ms, period_ms, warm_timer_cb, NULL);
+	}
+}
+
+static void warm_pool_trim(void)
+{
+	const uint64_t now = os_gettime_ns();
+	for (struct flutter_host **it = &g_warm.hosts; *it;) {
+		struct flutter_host *host = *it;
+		if (now - host->warm_since_ns < g_settings.warm_idle_ns) {
+			it = &host->next;
+			continue;
+		}
+		*it = host->next;
+		g_warm.count--;
+		g_warm.expired++;
+		host_shutdown(host);
+		const command_t cmd = {.type = CMD_FREE_HOST, .host = host};
+		queue_push(&g_queue, &cmd);
+	}
+	if (!g_warm.count)
+		warm_timer_stop();
+}
+
+/* CMD_EXIT: no task runs after this, so hosts are freed right away. */
+static void warm_pool_drain(void)
+{
+	warm_timer_stop();
+	while (g_warm.hosts) {
+		struct flutter_host *host = g_warm.hosts;
+		g_warm.hosts = host->next;
+		host_shutdown(host);
+		host_free(host);
+	}
+	g_warm.count = 0;
+
+	if (g_warm.hits + g_warm.misses)
+		blog(LOG_INFO, "[FlutterSource] warm engines: %llu claimed, %llu cold starts, %llu expired",
+		     (unsigned long long)g_warm.hits, (unsigned long long)g_warm.misses,
+		     (unsigned long long)g_warm.expired);
+	g_warm.hits = g_warm.misses = g_warm.expired = 0;
+}
+
+/* Any thread.  A refused view would never present a frame, so the worker
+ * moves the source off the shared engine. */
+static void on_view_added(const FlutterAddViewResult *result)
+{
+	if (result->added)
+		return;
+	struct flutter_source *ctx = result->user_data;
+	blog(LOG_ERROR, "[FlutterSource] shared engine refused view %lld, starting an engine of its own",
+	     (long long)ctx->view_id);
+	const command_t cmd = {.type = CMD_VIEW_REFUSED, .ctx = ctx};
+	queue_push(&g_queue, &cmd);
+}
+
+static void on_view_removed(const FlutterRemoveViewResult *result)
+{
+	pt_atomic_xchg((volatile long *)result->user_data, 0); // &host->removing[id]
+}
+
+/* Adds `ctx` to a running shared engine.  False when every view id is taken. */
+static bool host_join(struct flutter_host *host, struct flutter_source *ctx)
+{
+	FlutterViewId view_id = -1;
+	for (int i = 0; i < HOST_MAX_VIEWS && view_id < 0; ++i) {
+		if (!host->views[i] && !host->removing[i])
+			view_id = i;
+	}
+	if (view_id < 0)
+		return false;
+
+	host_add_view(host, ctx, view_id);
+
+	preload_start(ctx);
+	pt_atomic_xchg_ptr((void *volatile *)&ctx->engine, host->engine);
+
+	FlutterWindowMetricsEvent wm;
+	view_metrics(ctx, &wm);
+	if (view_id == 0) { // the implicit view always exists, it only had no source
+		g_embedder.SendWindowMetricsEvent(host->engine, &wm);
+	} else {
+		const FlutterAddViewInfo info = {
+			.struct_size = sizeof(info),
+			.view_id = view_id,
+			.view_metrics = &wm,
+			.user_data = ctx,
+			.add_view_callback = on_view_added,
+		};
+		g_embedder.AddView(host->engine, &info);
+	}
+	g_embedder.ScheduleFrame(host->engine);
+	host_update_lifecycle(host); // resumes an engine whose other views are all hidden
+
+	blog(LOG_INFO, "[FlutterSource] joined shared engine as view %lld (%ld views)", (long long)view_id,
+	     host->view_count);
+	return true;
+}
+
+/* Runs `ctx` on an engine of its own, warm if one is waiting. */
+static void host_start(struct flutter_source *ctx)
+{
+	// Warm engines have no compositor unless shared, so matte sources start their own
+	struct flutter_host *host = ctx->matte ? NULL : warm_pool_claim(ctx->shared_engine);
+	if (!host)
+		host = host_init(ctx->shared_engine, ctx->matte);
+	host_run(host, ctx);
+	host->next = g_hosts;
+	g_hosts = host;
+
+	// Replace the claimed engine once queued work (first frames included) has run
+	const command_t cmd = {.type = CMD_FILL_POOL};
+	queue_push(&g_queue, &cmd);
+}
+
+static void host_attach(struct flutter_source *ctx)
+{
+	log_tid("host_attach");
+
+	if (ctx->shared_engine) {
+		char assets[MAX_PATH], icu[MAX_PATH], aot[MAX_PATH];
+		locate_bundle(assets, icu, aot);
+
+		for (struct flutter_host *host = g_hosts; host; host = host->next) {
+			if (host->shared && host->engine && strcmp(host->assets_dir, assets) == 0 &&
+			    host_join(host, ctx)) {
+				pt_atomic_xchg(&ctx->started, 1);
+				return;
+			}
+		}
+	}
+
+	host_start(ctx);
+	pt_atomic_xchg(&ctx->started, 1);
+}
+
+static void host_stop(struct flutter_host *host)
+{
+	for (struct flutter_host **it = &g_hosts; *it; it = &(*it)->next) {
+		if (*it == host) {
+			*it = host->next;
+			break;
+		}
+	}
+
+	host_shutdown(host);
+
+	// Tasks the engine posted before shutting down still reference the host
+	const command_t cmd = {.type = CMD_FREE_HOST, .host = host};
+	queue_push(&g_queue, &cmd);
+}
+
+static void host_free(struct flutter_host *host)
+{
+	pt_rwlock_destroy(&host->views_lock);
+	pt_mutex_destroy(&host->lifecycle_cs);
+	bfree(host);
+}
+
+static void host_detach(struct flutter_source *ctx)
+{
+	log_tid("host_detach");
+	struct flutter_host *host = ctx->host;
+	if (!host)
+		return;
+
+	const FlutterViewId view_id = ctx->view_id;
+	if (ctx->suspended_on == host)
+		pt_atomic_dec(&host->suspended_views);
+	ctx->suspended_on = NULL;
+
+	bind_view_channels(host, view_id, NULL);
+	pt_rwlock_write_lock(&host->views_lock);
+	host->views[view_id] = NULL;
+	pt_rwlock_write_unlock(&host->views_lock);
+	const long views = pt_atomic_dec(&host->view_count);
+
+	ctx->engine = NULL;
+	ctx->host = NULL;
+
+	if (!views) {
+		host_stop(host);
+		return;
+	}
+	host_update_lifecycle(host); // the last visible view may just have left
+
+	// The implicit view can't be removed; it stays idle until another source claims it
+	if (view_id != 0 && host->engine) {
+		host->removing[view_id] = 1;
+		const FlutterRemoveViewInfo info = {
+			.struct_size = sizeof(info),
+			.view_id = view_id,
+			.user_data = (void *)&host->removing[view_id],
+			.remove_view_callback = on_view_removed,
+		};
+		if (g_embedder.RemoveView(host->engine, &info) != kSuccess)
+			host->removing[view_id] = 0;
+	}
+}
+
+/* The shared engine refused `ctx`'s view: leave it as a destroyed source
+ * would and start over on an engine of its own. */
+static void host_view_refused(struct flutter_source *ctx)
+{
+	// A source destroyed since was detached by its CMD_DESTROY_ENGINE; only compare pointers
+	bool attached = false;
+	for (struct flutter_host *host = g_hosts; host && !attached; host = host->next) {
+		for (int i = 0; i < HOST_MAX_VIEWS && !attached; ++i)
+			attached = host->views[i] == ctx;
+	}
+	if (!attached)
+		return;
+
+	pt_atomic_xchg(&ctx->started, 0); // the graphics thread leaves ctx->host alone
+	const bool suspended = ctx->suspended_on != NULL;
+	host_detach(ctx);
+	host_start(ctx);
+	if (suspended && ctx->host) {
+		ctx->suspended_on = ctx->host;
+		pt_atomic_inc(&ctx->host->suspended_views);
+		host_update_lifecycle(ctx->host);
+	}
+	pt_atomic_xchg(&ctx->started, 1);
 }
 
 //  ────────────────────────────────────────────────────────────────
@@ -502,61 +2004,273 @@ static const char *source_get_name(void *unused)
 	return "Flutter Source";
 }
 
-static VOID CALLBACK audio_tick(PVOID param, BOOLEAN timedOut)
+//  ────────────────────────────────────────────────────────────────
+//  Audio analysis tap (levels + spectrum streamed to a Dart SendPort)
+//  ────────────────────────────────────────────────────────────────
+
+/* Feeds one block and posts a packet once the configured period elapsed.
+ * Called from the thread that owns `a` (audio timer or OBS audio thread). */
+static void analysis_step(struct flutter_source *ctx, struct audio_analysis *a, uint64_t *due_ns,
+			  enum analysis_stream stream, uint32_t sample_rate, const float *left, const float *right,
+			  uint32_t frames)
 {
+	const FlutterEngineDartPort port = pt_atomic_cas64(&ctx->analysis_port, 0, 0);
+	if (!port || !ctx->engine)
+		return;
+
+	const uint32_t fft_size = (uint32_t)ctx->analysis_fft_size;
+	if (a->fft_size != fft_size || a->sample_rate != sample_rate) {
+		audio_analysis_free(a);
+		if (!audio_analysis_init(a, fft_size, sample_rate, stream))
+			return;
+	}
+
+	audio_analysis_feed(a, left, right, frames);
+
+	const uint64_t now = os_gettime_ns();
+	if (now < *due_ns)
+		return;
+	*due_ns = now + (uint64_t)ctx->analysis_interval_ms * 1000000ULL;
+
+	const uint8_t *packet = audio_analysis_pack(a);
+	const FlutterEngineDartBuffer buf = {
+		.struct_size = sizeof(FlutterEngineDartBuffer),
+		.buffer = (uint8_t *)packet, // copied by the VM (no collect callback)
+		.buffer_size = a->packet_size,
+	};
+	const FlutterEngineDartObject obj = {
+		.type = kFlutterEngineDartObjectTypeBuffer,
+		.buffer_value = &buf,
+	};
+	g_embedder.PostDartObject(ctx->engine, port, &obj);
+}
+
+static void analysis_capture_cb(void *param, obs_source_t *source, const struct audio_data *audio, bool muted)
+{
+	(void)source;
 	struct flutter_source *ctx = param;
+	if (muted || !audio->data[0])
+		return;
 
-	audio_cmd c;
-	while (pop(&g_cmdq, &c)) {
-		switch (c.type) {
-		case CMD_LOAD: {
-			if (c.id < 0 || c.id >= 256)
-				break;
-
-			if (ctx->sounds[c.id]) {
-				ma_sound_uninit(ctx->sounds[c.id]);
-				free(ctx->sounds[c.id]);
-			}
+	struct obs_audio_info oai;
+	if (!obs_get_audio_info(&oai))
+		return;
 
-			char full[MAX_PATH];
-			if (c.is_relative) {
-				snprintf(full, sizeof(full), "%s\\%s", ctx->assets_dir, c.path);
-			} else {
-				strncpy(full, c.path, sizeof(full));
-			}
+	const float *left = (const float *)audio->data[0];
+	const float *right = audio->data[1] ? (const float *)audio->data[1] : left;
+	analysis_step(ctx, &ctx->src_analysis, &ctx->src_analysis_due_ns, ANALYSIS_STREAM_SOURCE, oai.samples_per_sec,
+		      left, right, audio->frames);
+}
+
+static void analysis_detach_source(struct flutter_source *ctx)
+{
+	if (!ctx->analysis_target)
+		return;
 
-			ctx->sounds[c.id] = malloc(sizeof(ma_sound));
+	obs_source_t *target = obs_weak_source_get_source(ctx->analysis_target);
+	if (target) {
+		obs_source_remove_audio_capture_callback(target, analysis_capture_cb, ctx);
+		obs_source_release(target);
+	}
+	obs_weak_source_release(ctx->analysis_target);
+	ctx->analysis_target = NULL;
+	ctx->analysis_target_name[0] = '\0';
+}
+
+static void analysis_update(struct flutter_source *ctx, obs_data_t *settings)
+{
+	const long long rate = obs_data_get_int(settings, "analysis_rate");
+	pt_atomic_xchg(&ctx->analysis_fft_size,
+			    (long)audio_analysis_clamp_fft_size((uint32_t)obs_data_get_int(settings, "analysis_fft_size")));
+	pt_atomic_xchg(&ctx->analysis_interval_ms, (long)(1000 / (rate > 0 ? rate : 30)));
+
+	const char *name = obs_data_get_string(settings, "analysis_source");
+	if (!name)
+		name = "";
+	if (strcmp(name, ctx->analysis_target_name) == 0)
+		return;
 
-			const ma_result res = ma_sound_init_from_file(&ctx->ma, full,
-								      MA_SOUND_FLAG_DECODE | MA_SOUND_FLAG_ASYNC, NULL,
-								      NULL, ctx->sounds[c.id]);
+	analysis_detach_source(ctx);
+	if (!name[0])
+		return;
 
-			if (res == MA_SUCCESS) {
-				/* Sound loaded but not played yet */
-			} else {
-				blog(LOG_ERROR, "can't load %s (ma err %d)", full, res);
-				free(ctx->sounds[c.id]);
-				ctx->sounds[c.id] = NULL;
-			}
-			break;
+	obs_source_t *target = obs_get_source_by_name(name);
+	if (!target) {
+		blog(LOG_WARNING, "[FlutterSource] analysis source '%s' not found", name);
+		return;
+	}
+	if (target == ctx->source) {
+		obs_source_release(target);
+		return;
+	}
+
+	ctx->analysis_target = obs_source_get_weak_source(target);
+	strncpy(ctx->analysis_target_name, name, sizeof(ctx->analysis_target_name) - 1);
+	obs_source_add_audio_capture_callback(target, analysis_capture_cb, ctx);
+	obs_source_release(target);
+}
+
+static void on_load_decoded(ma_async_notification *notification)
+{
+	pending_load *pl = (pending_load *)notification;
+	pt_atomic_xchg(&pl->decoded, 1);
+}
+
+/* A newer load for the same id supersedes an awaited one.  miniaudio may
+ * still signal the old record, so it is parked until ma_engine_uninit. */
+static void cancel_pending_load(struct flutter_source *ctx, int id)
+{
+	for (pending_load **it = &ctx->pending_loads; *it; it = &(*it)->next) {
+		pending_load *pl = *it;
+		if (pl->id != id)
+			continue;
+		*it = pl->next;
+		audio_reply_release(ctx, pl->reply, false);
+		pl->next = ctx->cancelled_loads;
+		ctx->cancelled_loads = pl;
+		return;
+	}
+}
+
+/* Audio thread: completes the replies of loads that finished decoding. */
+static void poll_pending_loads(struct flutter_source *ctx)
+{
+	pending_load **it = &ctx->pending_loads;
+	while (*it) {
+		pending_load *pl = *it;
+		if (!pl->decoded) {
+			it = &pl->next;
+			continue;
 		}
-		case CMD_PLAY:
-			if (c.id < 256 && ctx->sounds[c.id]) {
-				ma_sound_set_volume(ctx->sounds[c.id], c.volume);
-				ma_sound_set_looping(ctx->sounds[c.id], c.loop);
-				ma_sound_start(ctx->sounds[c.id]);
-			}
-			break;
-		case CMD_STOP:
-			if (c.id < 256 && ctx->sounds[c.id])
-				ma_sound_stop(ctx->sounds[c.id]);
-			break;
-		case CMD_VOLUME:
-			if (c.id < 256 && ctx->sounds[c.id])
-				ma_sound_set_volume(ctx->sounds[c.id], c.volume);
+
+		ma_sound *sound = ctx->sounds[pl->id];
+		const ma_result res = ma_resource_manager_data_source_result(
+			(ma_resource_manager_data_source *)ma_sound_get_data_source(sound));
+		if (res == MA_SUCCESS) {
+			float seconds = 0.f;
+			ma_uint32 channels = 0;
+			ma_sound_get_length_in_seconds(sound, &seconds);
+			ma_sound_get_data_format(sound, NULL, &channels, NULL, NULL, 0);
+			pl->reply->duration = seconds;
+			pl->reply->channels = channels;
+		} else {
+			blog(LOG_ERROR, "[FlutterSource] decoding sound %d failed (ma err %d)", pl->id, res);
+		}
+		audio_reply_release(ctx, pl->reply, res == MA_SUCCESS);
+
+		*it = pl->next;
+		free(pl);
+	}
+}
+
+static bool load_sound(struct flutter_source *ctx, const audio_cmd *c)
+{
+	cancel_pending_load(ctx, c->id);
+	if (ctx->sounds[c->id]) {
+		ma_sound_uninit(ctx->sounds[c->id]);
+		free(ctx->sounds[c->id]);
+		ctx->sounds[c->id] = NULL;
+	}
+
+	char full[MAX_PATH];
+	resolve_sound_path(ctx, c->path, c->is_relative, full, sizeof(full));
+
+	ma_sound *sound = malloc(sizeof(ma_sound));
+	if (!sound) {
+		blog(LOG_ERROR, "[FlutterSource] Out of memory, can't load %s", full);
+		return false;
+	}
+	pending_load *pl = NULL;
+	ma_sound_config cfg = ma_sound_config_init_2(&ctx->ma);
+	cfg.pFilePath = full;
+	cfg.flags = MA_SOUND_FLAG_DECODE | MA_SOUND_FLAG_ASYNC;
+
+	if (c->reply) {
+		pl = calloc(1, sizeof(*pl));
+		if (!pl) {
+			blog(LOG_ERROR, "[FlutterSource] Out of memory, can't load %s", full);
+			free(sound);
+			return false;
+		}
+		pl->cb.onSignal = on_load_decoded;
+		pl->id = c->id;
+		pl->reply = c->reply;
+		cfg.initNotifications.done.pNotification = pl;
+	}
+
+	const ma_result res = ma_sound_init_ex(&ctx->ma, &cfg, sound);
+	if (res != MA_SUCCESS) {
+		blog(LOG_ERROR, "can't load %s (ma err %d)", full, res);
+		free(sound);
+		free(pl);
+		return false;
+	}
+
+	/* Sound loaded but not played yet */
+	ctx->sounds[c->id] = sound;
+	if (pl) {
+		pl->next = ctx->pending_loads;
+		ctx->pending_loads = pl;
+	}
+	return true;
+}
+
+static void apply_audio_cmd(struct flutter_source *ctx, const audio_cmd *c)
+{
+	const bool valid = c->id >= 0 && c->id < 256;
+	ma_sound *sound = valid ? ctx->sounds[c->id] : NULL;
+	bool ok = sound != NULL;
+
+	switch (c->type) {
+	case CMD_LOAD:
+		if (!valid)
 			break;
+		if (load_sound(ctx, c) && c->reply)
+			return; // replied by poll_pending_loads() once decoded
+		ok = false;
+		break;
+	case CMD_PLAY:
+		if (sound) {
+			ma_sound_set_volume(sound, c->volume);
+			ma_sound_set_looping(sound, c->loop);
+			ma_sound_start(sound);
 		}
+		break;
+	case CMD_STOP:
+		if (sound)
+			ma_sound_stop(sound);
+		break;
+	case CMD_VOLUME:
+		if (sound)
+			ma_sound_set_volume(sound, c->volume);
+		break;
+	}
+
+	if (c->reply)
+		audio_reply_release(ctx, c->reply, ok);
+}
+
+static void audio_tick(void *param)
+{
+	struct flutter_source *ctx = param;
+	const uint64_t tick_ns = os_gettime_ns();
+	thread_sched_enter(THREAD_CLASS_AUDIO); // pooled timer threads on Windows
+	if (ctx->last_audio_tick_ns) {
+		const int64_t error = (int64_t)(tick_ns - ctx->last_audio_tick_ns) - 20000000;
+		latency_histogram_add(&ctx->audio_jitter, (uint64_t)(error < 0 ? -error : error));
+	}
+	ctx->last_audio_tick_ns = tick_ns;
+
+	// Commands may name preloaded ids: they wait until the manifest is resident
+	if (preload_finish(ctx, false)) {
+		audio_cmd c;
+		while (pop(&ctx->cmdq, &c))
+			apply_audio_cmd(ctx, &c);
+		while (pop(&ctx->ffi_cmdq, &c))
+			apply_audio_cmd(ctx, &c);
 	}
+	poll_pending_loads(ctx);
+	pt_atomic_inc64(&ctx->audio_ticks);
 
 	ma_engine_read_pcm_frames(&ctx->ma, ctx->mix_int, 960, NULL);
 
@@ -565,6 +2279,9 @@ static VOID CALLBACK audio_tick(PVOID param, BOOLEAN timedOut)
 		ctx->mix_R[i] = ctx->mix_int[i * 2 + 1];
 	}
 
+	analysis_step(ctx, &ctx->mix_analysis, &ctx->mix_analysis_due_ns, ANALYSIS_STREAM_MIX, 48000, ctx->mix_L,
+		      ctx->mix_R, 960);
+
 	const struct obs_source_audio out = {
 		.data = {(uint8_t *)ctx->mix_L, (uint8_t *)ctx->mix_R},
 		.frames = 960,
@@ -575,6 +2292,300 @@ static VOID CALLBACK audio_tick(PVOID param, BOOLEAN timedOut)
 	};
 
 	obs_source_output_audio(ctx->source, &out);
+	pt_atomic_add64(&ctx->audio_ns_total, (int64_t)(os_gettime_ns() - tick_ns));
+}
+
+//  ────────────────────────────────────────────────────────────────
+//  Dart FFI direct-call API (see include/obs-flutter-api.h)
+//  ────────────────────────────────────────────────────────────────
+
+#define FFI_MAX_SOURCES 64
+
+static struct flutter_source *g_ffi_sources[FFI_MAX_SOURCES];
+static pt_rwlock g_ffi_lock = PT_RWLOCK_INIT; // shared: callers, exclusive: (un)registration
+static int64_t g_ffi_generation = 0;
+
+/* handle = generation << 8 | slot; generations are never reused */
+static void ffi_register(struct flutter_source *ctx)
+{
+	pt_rwlock_write_lock(&g_ffi_lock);
+	for (int slot = 0; slot < FFI_MAX_SOURCES; ++slot) {
+		if (!g_ffi_sources[slot]) {
+			g_ffi_sources[slot] = ctx;
+			ctx->ffi_handle = (++g_ffi_generation << 8) | slot;
+			break;
+		}
+	}
+	pt_rwlock_write_unlock(&g_ffi_lock);
+}
+
+/* Waits for in-flight FFI calls on this source to leave. */
+static void ffi_unregister(struct flutter_source *ctx)
+{
+	pt_rwlock_write_lock(&g_ffi_lock);
+	const int slot = (int)(ctx->ffi_handle & 0xff);
+	if (ctx->ffi_handle && g_ffi_sources[slot] == ctx)
+		g_ffi_sources[slot] = NULL;
+	pt_rwlock_write_unlock(&g_ffi_lock);
+}
+
+/* On success the shared lock is held; release with ffi_release(). */
+static struct flutter_source *ffi_acquire(int64_t handle)
+{
+	const int64_t slot = handle & 0xff;
+	if (handle <= 0 || slot >= FFI_MAX_SOURCES)
+		return NULL;
+
+	pt_rwlock_read_lock(&g_ffi_lock);
+	struct flutter_source *ctx = g_ffi_sources[slot];
+	if (!ctx || ctx->ffi_handle != handle) {
+		pt_rwlock_read_unlock(&g_ffi_lock);
+		return NULL;
+	}
+	return ctx;
+}
+
+static void ffi_release(void)
+{
+	pt_rwlock_read_unlock(&g_ffi_lock);
+}
+
+static int32_t ffi_push(int64_t handle, const audio_cmd *c)
+{
+	if (c->id < 0 || c->id >= 256)
+		return OBS_FLUTTER_INVALID_ARGUMENT;
+
+	struct flutter_source *ctx = ffi_acquire(handle);
+	if (!ctx)
+		return OBS_FLUTTER_INVALID_HANDLE;
+
+	int32_t result = OBS_FLUTTER_BUSY;
+	if (pt_atomic_cas(&ctx->ffi_busy, 1, 0) == 0) {
+		result = push(&ctx->ffi_cmdq, c) ? OBS_FLUTTER_OK : OBS_FLUTTER_QUEUE_FULL;
+		pt_atomic_xchg(&ctx->ffi_busy, 0);
+	}
+	ffi_release();
+	return result;
+}
+
+OBS_FLUTTER_EXPORT uint32_t obs_flutter_api_version(void)
+{
+	return OBS_FLUTTER_API_VERSION;
+}
+
+OBS_FLUTTER_EXPORT int32_t obs_flutter_audio_load(int64_t source, int32_t id, const char *asset, int32_t absolute)
+{
+	if (!asset || !asset[0])
+		return OBS_FLUTTER_INVALID_ARGUMENT;
+
+	audio_cmd c = {.type = CMD_LOAD, .id = id, .volume = 1.f, .is_relative = !absolute};
+	strncpy(c.path, asset, sizeof(c.path) - 1);
+	return ffi_push(source, &c);
+}
+
+OBS_FLUTTER_EXPORT int32_t obs_flutter_audio_play(int64_t source, int32_t id, float volume, int32_t loop)
+{
+	const audio_cmd c = {.type = CMD_PLAY, .id = id, .volume = volume, .loop = loop != 0};
+	return ffi_push(source, &c);
+}
+
+OBS_FLUTTER_EXPORT int32_t obs_flutter_audio_stop(int64_t source, int32_t id)
+{
+	const audio_cmd c = {.type = CMD_STOP, .id = id};
+	return ffi_push(source, &c);
+}
+
+OBS_FLUTTER_EXPORT int32_t obs_flutter_audio_volume(int64_t source, int32_t id, float volume)
+{
+	const audio_cmd c = {.type = CMD_VOLUME, .id = id, .volume = volume};
+	return ffi_push(source, &c);
+}
+
+OBS_FLUTTER_EXPORT int32_t obs_flutter_get_stats(int64_t source, obs_flutter_stats *out)
+{
+	if (!out || out->struct_size < sizeof(uint32_t))
+		return OBS_FLUTTER_INVALID_ARGUMENT;
+
+	struct flutter_source *ctx = ffi_acquire(source);
+	if (!ctx)
+		return OBS_FLUTTER_INVALID_HANDLE;
+
+	obs_flutter_stats st = {.struct_size = sizeof(st)};
+	st.width = ctx->width;
+	st.height = ctx->height;
+	for (int i = 0; i < 256; ++i)
+		st.sounds_loaded += ctx->sounds[i] != NULL;
+	st.frames_presented = (uint64_t)ctx->frames_presented;
+	st.audio_ticks = (uint64_t)ctx->audio_ticks;
+	st.platform_messages = (uint64_t)ctx->platform_messages;
+	st.render_calls = (uint64_t)ctx->render_calls;
+	st.render_ns_total = (uint64_t)ctx->render_ns_total;
+	st.render_ns_max = (uint64_t)ctx->render_ns_max;
+	st.first_frame_ns = (uint64_t)ctx->first_frame_ns;
+	st.frames_uploaded = ctx->frames_uploaded;
+	st.upload_latency_p50_ns = latency_histogram_percentile(&ctx->upload_latency, 0.50);
+	st.upload_latency_p99_ns = latency_histogram_percentile(&ctx->upload_latency, 0.99);
+	st.audio_jitter_p99_ns = latency_histogram_percentile(&ctx->audio_jitter, 0.99);
+	st.present_ns_total = (uint64_t)ctx->present_ns_total;
+	st.audio_ns_total = (uint64_t)ctx->audio_ns_total;
+	st.governor_scale_pct = (uint32_t)ctx->governor.scale_pct;
+	st.governor_frame_divider = (uint32_t)ctx->governor.divider;
+	st.governor_changes = ctx->governor.changes;
+	ffi_release();
+
+	const uint32_t n = out->struct_size < sizeof(st) ? out->struct_size : (uint32_t)sizeof(st);
+	memcpy(out, &st, n);
+	out->struct_size = n;
+	return OBS_FLUTTER_OK;
+}
+
+//  ────────────────────────────────────────────────────────────────
+//  Suspension while the source is neither shown nor active
+//  ────────────────────────────────────────────────────────────────
+
+static void audio_timer_start(struct flutter_source *ctx)
+{
+	if (!ctx->audio_timer)
+		ctx->audio_timer = pt_timer_start(0, 20, audio_tick, ctx);
+}
+
+/* Waits for a running audio_tick to return. */
+static void audio_timer_stop(struct flutter_source *ctx)
+{
+	pt_timer_stop(ctx->audio_timer);
+	ctx->audio_timer = NULL;
+	ctx->last_audio_tick_ns = 0; // a suspension gap is not jitter
+}
+
+static void send_lifecycle(FlutterEngine engine, const char *state)
+{
+	g_embedder.SendPlatformMessage(engine,
+					 &(FlutterPlatformMessage){.struct_size = sizeof(FlutterPlatformMessage),
+								   .channel = "flutter/lifecycle",
+								   .message = (const uint8_t *)state,
+								   .message_size = strlen(state)});
+}
+
+/* A paused app stops scheduling frames, so the raster thread idles too.  An
+ * engine is paused once none of its views is visible and resumed as soon as
+ * one is.  Views join and leave on the worker while suspension changes on
+ * the graphics thread; the lock makes each decision see the latest counts
+ * and keeps the messages in the order the decisions were made. */
+static void host_update_lifecycle(struct flutter_host *host)
+{
+	pt_mutex_lock(&host->lifecycle_cs);
+	const long views = host->view_count;
+	const bool pause = host->suspended_views >= views;
+	if (views && host->engine && pause != host->paused) {
+		host->paused = pause;
+		if (pause) {
+			send_lifecycle(host->engine, "AppLifecycleState.hidden");
+			send_lifecycle(host->engine, "AppLifecycleState.paused");
+		} else {
+			send_lifecycle(host->engine, "AppLifecycleState.resumed");
+		}
+	}
+	pt_mutex_unlock(&host->lifecycle_cs);
+}
+
+/* Graphics thread.  Fails while the raster thread is still copying into a
+ * slot; retried on the next tick. */
+static bool release_frame_buffers(struct flutter_source *ctx)
+{
+	obs_enter_graphics();
+	pt_mutex_lock(&ctx->tex_cs);
+
+	bool writing = false;
+	for (int i = 0; i < UPLOAD_RING; ++i)
+		writing |= ctx->upload[i].state == SLOT_WRITING;
+
+	if (!writing) {
+		upload_ring_free(ctx);
+		free(ctx->pixel_data);
+		ctx->pixel_data = NULL;
+		ctx->pixel_cap = 0;
+		ctx->pixel_seq = 0;
+		ctx->frame_width = ctx->frame_height = 0;
+	}
+
+	pt_mutex_unlock(&ctx->tex_cs);
+	obs_leave_graphics();
+	return !writing;
+}
+
+static void suspend(struct flutter_source *ctx)
+{
+	pt_mutex_lock(&ctx->tex_cs);
+	pt_atomic_xchg(&ctx->suspended, 1);
+	pt_mutex_unlock(&ctx->tex_cs);
+
+	struct flutter_host *host = ctx->host;
+	if (host) {
+		ctx->suspended_on = host;
+		pt_atomic_inc(&host->suspended_views);
+		host_update_lifecycle(host);
+	}
+	audio_timer_stop(ctx);
+	ctx->release_pending = ctx->release_hidden && !release_frame_buffers(ctx);
+}
+
+static void resume(struct flutter_source *ctx)
+{
+	ctx->release_pending = false;
+	pt_atomic_xchg(&ctx->suspended, 0);
+
+	audio_timer_start(ctx);
+	struct flutter_host *host = ctx->suspended_on;
+	ctx->suspended_on = NULL;
+	if (host) {
+		pt_atomic_dec(&host->suspended_views);
+		host_update_lifecycle(host);
+	}
+	if (ctx->engine)
+		g_embedder.ScheduleFrame(ctx->engine);
+}
+
+/* Graphics thread, from video_tick: transitions take effect before the
+ * next render. */
+static void update_suspension(struct flutter_source *ctx)
+{
+	if (!ctx->started) // the worker still owns ctx->host
+		return;
+
+	const bool visible = ctx->showing || ctx->active;
+
+	if (visible && ctx->suspended)
+		resume(ctx);
+	else if (!visible && !ctx->suspended)
+		suspend(ctx);
+	else if (ctx->release_pending)
+		ctx->release_pending = !release_frame_buffers(ctx);
+}
+
+static void source_show(void *data)
+{
+	pt_atomic_xchg(&((struct flutter_source *)data)->showing, 1);
+}
+
+static void source_hide(void *data)
+{
+	pt_atomic_xchg(&((struct flutter_source *)data)->showing, 0);
+}
+
+static void source_activate(void *data)
+{
+	pt_atomic_xchg(&((struct flutter_source *)data)->active, 1);
+}
+
+static void source_deactivate(void *data)
+{
+	pt_atomic_xchg(&((struct flutter_source *)data)->active, 0);
+}
+
+static uint32_t render_scale(obs_data_t *settings)
+{
+	const long long pct = obs_data_get_int(settings, "render_scale");
+	return pct < 25 ? (pct ? 25 : 100) : pct > 100 ? 100 : (uint32_t)pct;
 }
 
 static void *source_create(obs_data_t *settings, obs_source_t *src)
@@ -585,9 +2596,9 @@ static void *source_create(obs_data_t *settings, obs_source_t *src)
 	ctx->height = (uint32_t)obs_data_get_int(settings, "height");
 	ctx->pixel_ratio_pct = (uint32_t)obs_data_get_int(settings, "pixel_ratio");
 
-	// Allocate pixel buffer for the software renderer
-	InitializeCriticalSection(&ctx->tex_cs);
-	ctx->pixel_data = calloc(ctx->width * ctx->height, 4);
+	// The pixel buffer is sized by the first frame the software renderer presents
+	pt_mutex_init(&ctx->tex_cs);
+	ctx->shown = -1;
 
 	if (!ctx->width)
 		ctx->width = 320;
@@ -595,12 +2606,24 @@ static void *source_create(obs_data_t *settings, obs_source_t *src)
 		ctx->height = 240;
 	if (!ctx->pixel_ratio_pct)
 		ctx->pixel_ratio_pct = 100;
+	ctx->render_scale_pct = render_scale(settings);
+	ctx->bicubic_upscale = obs_data_get_bool(settings, "bicubic_upscale");
+	ctx->req_width = ctx->width;
+	ctx->req_height = ctx->height;
+	ctx->req_ratio_pct = ctx->pixel_ratio_pct;
+	ctx->req_render_scale_pct = ctx->render_scale_pct;
+
+	ctx->req_governor = obs_data_get_bool(settings, "governor");
+	ctx->req_min_scale_pct = (uint32_t)obs_data_get_int(settings, "governor_min_scale");
+	ctx->req_max_divider = (uint32_t)obs_data_get_int(settings, "governor_max_divider");
+	governor_init(&ctx->governor);
+	governor_configure(&ctx->governor, ctx->req_governor, ctx->req_min_scale_pct, ctx->req_max_divider);
 
 	const char *json_str = obs_data_get_string(settings, "dart_config");
-	if (json_str && json_str[0])
-		strncpy(ctx->dart_config, json_str, sizeof(ctx->dart_config) - 1);
-	else
-		strncpy(ctx->dart_config, "{\n\t\n}", sizeof(ctx->dart_config) - 1);
+	pt_mutex_init(&ctx->config_cs);
+	ctx->dart_config = bstrdup(json_str && json_str[0] ? json_str : DEFAULT_DART_CONFIG);
+	ctx->dart_config_tree = cJSON_Parse(ctx->dart_config);
+	ctx->config_latest = bstrdup(ctx->dart_config);
 
 	/* START Audio Config */
 	ma_engine_config ecfg = ma_engine_config_init();
@@ -617,35 +2640,99 @@ static void *source_create(obs_data_t *settings, obs_source_t *src)
 	ctx->mix_L = malloc(sizeof(float) * 960);
 	ctx->mix_R = malloc(sizeof(float) * 960);
 
-	CreateTimerQueueTimer(&ctx->audio_timer, NULL, audio_tick, ctx, 0, 20, WT_EXECUTEDEFAULT);
+	analysis_update(ctx, settings);
+
+	ctx->release_hidden = obs_data_get_bool(settings, "release_hidden");
+	ctx->shared_engine = obs_data_get_bool(settings, "shared_engine");
+	ctx->matte = obs_data_get_bool(settings, "matte");
+	audio_timer_start(ctx);
 	/* END Audio Config */
 
-	if (InterlockedIncrement(&g_source_count) == 1)
+	ffi_register(ctx);
+
+	if (pt_atomic_inc(&g_source_count) == 1)
 		ensure_worker_thread();
 
-	// Request engine creation on worker thread (synchronous)
-	HANDLE done = CreateEvent(NULL, FALSE, FALSE, NULL);
-	command_t cmd = {.type = CMD_CREATE_ENGINE, .ctx = ctx, .done_event = done};
+	/* Request engine creation on the worker thread without waiting for it:
+	 * the source draws nothing until the first frame is presented. */
+	ctx->create_ns = os_gettime_ns();
+	const command_t cmd = {.type = CMD_CREATE_ENGINE, .ctx = ctx};
 	queue_push(&g_queue, &cmd);
-	WaitForSingleObject(done, INFINITE);
-	CloseHandle(done);
 	return ctx;
 }
 
+/* After engine shutdown: nobody can be answered any more, free what is
+ * still in flight without posting flushes for a dying source. */
+static void drop_audio_replies(struct flutter_source *ctx)
+{
+	audio_cmd c;
+	while (pop(&ctx->cmdq, &c)) {
+		if (c.reply && pt_atomic_dec(&c.reply->pending) == 0)
+			free(c.reply);
+	}
+
+	while (ctx->pending_loads) {
+		pending_load *pl = ctx->pending_loads;
+		ctx->pending_loads = pl->next;
+		if (pt_atomic_dec(&pl->reply->pending) == 0)
+			free(pl->reply);
+		free(pl);
+	}
+	while (ctx->cancelled_loads) {
+		pending_load *pl = ctx->cancelled_loads;
+		ctx->cancelled_loads = pl->next;
+		free(pl);
+	}
+
+	audio_reply *r = take_audio_replies(ctx);
+	while (r) {
+		audio_reply *next = r->next;
+		free(r);
+		r = next;
+	}
+}
+
+/* One line per source summarising its lifetime: throughput, latency from
+ * engine present to drawable texture, audio timer jitter and the CPU time
+ * spent on each thread, per second of lifetime. */
+static void log_pipeline_stats(const struct flutter_source *ctx)
+{
+	const double secs = (double)(os_gettime_ns() - ctx->create_ns) / 1e9;
+	if (secs <= 0.0 || !ctx->frames_presented)
+		return;
+
+	blog(LOG_INFO,
+	     "[FlutterSource] pipeline %ux%u over %.0f s: %.1f fps presented, %.1f fps uploaded, "
+	     "present->upload p50 %.2f ms p99 %.2f ms, audio jitter p99 %.2f ms, "
+	     "CPU ms/s: present %.2f, render %.2f, audio %.2f",
+	     ctx->frame_width, ctx->frame_height, secs, (double)ctx->frames_presented / secs,
+	     (double)ctx->frames_uploaded / secs, latency_histogram_percentile(&ctx->upload_latency, 0.50) / 1e6,
+	     latency_histogram_percentile(&ctx->upload_latency, 0.99) / 1e6,
+	     latency_histogram_percentile(&ctx->audio_jitter, 0.99) / 1e6, (double)ctx->present_ns_total / 1e6 / secs,
+	     (double)ctx->render_ns_total / 1e6 / secs, (double)ctx->audio_ns_total / 1e6 / secs);
+}
+
 static void source_destroy(void *data)
 {
 	struct flutter_source *ctx = data;
 
+	// Stop everything that may post to the engine before it goes away
+	ffi_unregister(ctx);
+	pt_atomic_xchg64(&ctx->analysis_port, 0);
+	analysis_detach_source(ctx);
+	audio_timer_stop(ctx);
+
 	// Request engine shutdown (synchronous)
-	HANDLE done = CreateEvent(NULL, FALSE, FALSE, NULL);
-	command_t cmd = {.type = CMD_DESTROY_ENGINE, .ctx = ctx, .done_event = done};
+	pt_sem done;
+	pt_sem_init(&done, 0);
+	const command_t cmd = {.type = CMD_DESTROY_ENGINE, .ctx = ctx, .done = &done};
 	queue_push(&g_queue, &cmd);
-	WaitForSingleObject(done, INFINITE);
-	CloseHandle(done);
+	pt_sem_wait(&done);
+	pt_sem_destroy(&done);
 
 	/* =========== START Release Audio =========== */
-	if (ctx->audio_timer)
-		DeleteTimerQueueTimer(NULL, ctx->audio_timer, INVALID_HANDLE_VALUE);
+
+	preload_finish(ctx, true); // never installed if the audio timer was stopped
 
 	for (int i = 0; i < 256; ++i) {
 		if (ctx->sounds[i]) {
@@ -656,43 +2743,229 @@ static void source_destroy(void *data)
 	}
 
 	ma_engine_uninit(&ctx->ma);
+	drop_audio_replies(ctx);
 
 	free(ctx->mix_int);
 	free(ctx->mix_L);
 	free(ctx->mix_R);
+
+	audio_analysis_free(&ctx->mix_analysis);
+	audio_analysis_free(&ctx->src_analysis);
 	/* ============ END Release Audio ============ */
 
-	EnterCriticalSection(&ctx->tex_cs);
+	if (ctx->render_calls)
+		blog(LOG_INFO, "[FlutterSource] render: %lld calls, %.3f ms avg, %.3f ms max", (long long)ctx->render_calls,
+		     (double)ctx->render_ns_total / (double)ctx->render_calls / 1e6, (double)ctx->render_ns_max / 1e6);
+	log_pipeline_stats(ctx);
 
-	if (ctx->texture)
-		gs_texture_destroy(ctx->texture);
-	ctx->texture = NULL;
+	// Same lock order as source_render: graphics context, then tex_cs
+	obs_enter_graphics();
+	pt_mutex_lock(&ctx->tex_cs);
+
+	upload_ring_free(ctx);
 
 	free(ctx->pixel_data);
 	ctx->pixel_data = NULL;
 
-	LeaveCriticalSection(&ctx->tex_cs);
-	DeleteCriticalSection(&ctx->tex_cs);
+	pt_mutex_unlock(&ctx->tex_cs);
+	obs_leave_graphics();
+	pt_mutex_destroy(&ctx->tex_cs);
+
+	bfree(ctx->dart_config);
+	cJSON_Delete(ctx->dart_config_tree);
+	bfree(ctx->config_latest);
+	pt_mutex_destroy(&ctx->config_cs);
 	bfree(ctx);
 
-	if (InterlockedDecrement(&g_source_count) == 0)
+	if (pt_atomic_dec(&g_source_count) == 0)
 		stop_worker_thread();
 }
 
-static void source_render(void *data, const gs_effect_t *effect)
+//  ────────────────────────────────────────────────────────────────
+//  Texture upload ring (graphics thread, under tex_cs)
+//  ────────────────────────────────────────────────────────────────
+
+static void slot_unmap(struct upload_slot *u)
 {
-	struct flutter_source *ctx = data;
+	gs_texture_unmap(u->tex);
+	u->ptr = NULL;
+	u->state = SLOT_IDLE;
+}
+
+static void show_slot(struct flutter_source *ctx, int index)
+{
+	if (ctx->shown >= 0 && ctx->shown != index)
+		ctx->upload[ctx->shown].state = SLOT_IDLE;
+	ctx->upload[index].state = SLOT_SHOWN;
+	ctx->shown = index;
+}
+
+/* Re-creates `u` at the current frame size (from the pool) if needed. */
+static bool slot_fit(struct flutter_source *ctx, struct upload_slot *u)
+{
+	if (u->tex && u->width == ctx->frame_width && u->height == ctx->frame_height)
+		return true;
+
+	if (u->state == SLOT_MAPPED || u->state == SLOT_FILLED)
+		slot_unmap(u);
+	texture_pool_release(u->tex);
+	u->tex = texture_pool_acquire(ctx->frame_width, ctx->frame_height, ctx->matte ? GS_R8 : GS_BGRA);
+	u->width = ctx->frame_width;
+	u->height = ctx->frame_height;
+	u->state = SLOT_IDLE;
+	return u->tex != NULL;
+}
+
+static void frame_uploaded(struct flutter_source *ctx, const struct upload_slot *u)
+{
+	ctx->frames_uploaded++;
+	latency_histogram_add(&ctx->upload_latency, os_gettime_ns() - u->present_ns);
+}
+
+static void upload_ring_step(struct flutter_source *ctx)
+{
+	if (!ctx->frame_width || !ctx->frame_height)
+		return;
+
+	/* newest complete frame: a filled slot or the fallback buffer */
+	int filled = -1;
+	for (int i = 0; i < UPLOAD_RING; ++i) {
+		const struct upload_slot *u = &ctx->upload[i];
+		if (u->state == SLOT_FILLED && (filled < 0 || u->seq > ctx->upload[filled].seq))
+			filled = i;
+	}
+	const uint64_t filled_seq = filled >= 0 ? ctx->upload[filled].seq : 0;
+
+	if (ctx->pixel_seq > filled_seq) {
+		for (int i = 0; i < UPLOAD_RING; ++i) {
+			struct upload_slot *u = &ctx->upload[i];
+			if (i == ctx->shown || u->state == SLOT_WRITING || !slot_fit(ctx, u))
+				continue;
+			if (u->state == SLOT_MAPPED || u->state == SLOT_FILLED)
+				slot_unmap(u);
+			gs_texture_set_image(u->tex, ctx->pixel_data, ctx->frame_stride, false);
+			u->seq = ctx->pixel_seq;
+			u->present_ns = ctx->pixel_present_ns;
+			show_slot(ctx, i);
+			frame_uploaded(ctx, u);
+			break;
+		}
+		ctx->pixel_seq = 0;
+	} else if (filled >= 0) {
+		gs_texture_unmap(ctx->upload[filled].tex);
+		ctx->upload[filled].ptr = NULL;
+		show_slot(ctx, filled);
+		frame_uploaded(ctx, &ctx->upload[filled]);
+	}
+
+	/* older filled frames are superseded; their slots go back to the producer */
+	for (int i = 0; i < UPLOAD_RING; ++i) {
+		if (ctx->upload[i].state == SLOT_FILLED)
+			ctx->upload[i].state = SLOT_MAPPED;
+	}
+
+	/* keep every spare slot mapped at the current size */
+	for (int i = 0; i < UPLOAD_RING; ++i) {
+		struct upload_slot *u = &ctx->upload[i];
+		if (i == ctx->shown || u->state == SLOT_WRITING || !slot_fit(ctx, u))
+			continue;
+		if (u->state == SLOT_IDLE && gs_texture_map(u->tex, &u->ptr, &u->linesize))
+			u->state = SLOT_MAPPED;
+	}
+}
+
+/* Graphics context, after the engine has stopped presenting. */
+static void upload_ring_free(struct flutter_source *ctx)
+{
+	for (int i = 0; i < UPLOAD_RING; ++i) {
+		struct upload_slot *u = &ctx->upload[i];
+		if (u->state == SLOT_MAPPED || u->state == SLOT_FILLED)
+			slot_unmap(u);
+		texture_pool_release(u->tex);
+		memset(u, 0, sizeof(*u));
+	}
+	ctx->shown = -1;
+}
+
+static void render_time_add(struct flutter_source *ctx, uint64_t ns)
+{
+	pt_atomic_inc64(&ctx->render_calls);
+	pt_atomic_add64(&ctx->render_ns_total, (int64_t)ns);
+	if ((int64_t)ns > ctx->render_ns_max)
+		pt_atomic_xchg64(&ctx->render_ns_max, (int64_t)ns);
+}
+
+static gs_effect_t *g_matte_effect; // graphics context, data/matte.effect
+static bool g_matte_effect_failed;
+
+static gs_effect_t *matte_effect(void)
+{
+	if (!g_matte_effect && !g_matte_effect_failed) {
+		char *path = obs_module_file("matte.effect");
+		g_matte_effect = path ? gs_effect_create_from_file(path, NULL) : NULL;
+		g_matte_effect_failed = !g_matte_effect;
+		if (g_matte_effect_failed)
+			blog(LOG_ERROR, "[FlutterSource] can't load %s", path ? path : "matte.effect");
+		bfree(path);
+	}
+	return g_matte_effect;
+}
+
+/* obs_module_unload, inside the graphics context. */
+void flutter_source_free_graphics(void)
+{
+	gs_effect_destroy(g_matte_effect);
+	g_matte_effect = NULL;
+	g_matte_effect_failed = false;
+}
+
+/* Matte sources hold linear coverage, not colour: no sRGB conversion. */
+static void render_matte(struct flutter_source *ctx, gs_texture_t *tex)
+{
+	gs_effect_t *effect = matte_effect();
+	if (!effect)
+		return;
+
+	const bool srgb_prev = gs_framebuffer_srgb_enabled();
+	gs_enable_framebuffer_srgb(false);
+	gs_blend_state_push();
+	gs_blend_function(GS_BLEND_ONE, GS_BLEND_INVSRCALPHA);
 
-	EnterCriticalSection(&ctx->tex_cs);
-	if (!ctx->texture)
-		ctx->texture = gs_texture_create(ctx->width, ctx->height, GS_BGRA, 1, NULL, GS_DYNAMIC);
-	LeaveCriticalSection(&ctx->tex_cs);
+	gs_effect_set_texture(gs_effect_get_param_by_name(effect, "image"), tex);
+	while (gs_effect_loop(effect, "Draw"))
+		gs_draw_sprite(tex, 0, ctx->width, ctx->height);
 
-	if (InterlockedCompareExchange(&ctx->dirty_pixels, 0, 1) == 1)
-		gs_texture_set_image(ctx->texture, ctx->pixel_data, ctx->width * 4, false);
+	gs_blend_state_pop();
+	gs_enable_framebuffer_srgb(srgb_prev);
+}
+
+/* Custom draw: frames rendered below the output size are stretched here,
+ * bilinear through the default effect's sampler or bicubic. */
+static void source_render(void *data, const gs_effect_t *unused)
+{
+	struct flutter_source *ctx = data;
+	(void)unused; // NULL with OBS_SOURCE_CUSTOM_DRAW
+
+	const uint64_t start_ns = os_gettime_ns();
+
+	/* A frame being copied holds tex_cs only briefly, but never wait for
+	 * it: on contention keep drawing what is already uploaded. */
+	if (pt_atomic_cas(&ctx->dirty_pixels, 0, 1) == 1) {
+		if (pt_mutex_trylock(&ctx->tex_cs)) {
+			upload_ring_step(ctx);
+			pt_mutex_unlock(&ctx->tex_cs);
+		} else {
+			pt_atomic_xchg(&ctx->dirty_pixels, 1);
+		}
+	}
 
-	if (!ctx->texture)
+	gs_texture_t *tex = ctx->shown >= 0 ? ctx->upload[ctx->shown].tex : NULL;
+	if (!tex || ctx->matte) {
+		if (tex)
+			render_matte(ctx, tex);
+		render_time_add(ctx, os_gettime_ns() - start_ns);
 		return;
+	}
 
 	bool srgb_prev = gs_framebuffer_srgb_enabled();
 	gs_enable_framebuffer_srgb(true);
@@ -700,12 +2973,27 @@ static void source_render(void *data, const gs_effect_t *effect)
 	gs_blend_state_push();
 	gs_blend_function(GS_BLEND_ONE, GS_BLEND_INVSRCALPHA);
 
-	gs_eparam_t *img_param = gs_effect_get_param_by_name(effect, "image");
-	gs_effect_set_texture_srgb(img_param, ctx->texture);
-	gs_draw_sprite(ctx->texture, 0, ctx->width, ctx->height);
+	const uint32_t tex_w = gs_texture_get_width(tex), tex_h = gs_texture_get_height(tex);
+	const bool bicubic = ctx->bicubic_upscale && (tex_w < ctx->width || tex_h < ctx->height);
+	gs_effect_t *effect = obs_get_base_effect(bicubic ? OBS_EFFECT_BICUBIC : OBS_EFFECT_DEFAULT);
+	gs_effect_set_texture_srgb(gs_effect_get_param_by_name(effect, "image"), tex);
+	if (bicubic) {
+		struct vec2 dim, dim_i;
+		vec2_set(&dim, (float)tex_w, (float)tex_h);
+		vec2_set(&dim_i, 1.0f / (float)tex_w, 1.0f / (float)tex_h);
+		gs_effect_set_vec2(gs_effect_get_param_by_name(effect, "base_dimension"), &dim);
+		gs_effect_set_vec2(gs_effect_get_param_by_name(effect, "base_dimension_i"), &dim_i);
+		gs_eparam_t *undistort = gs_effect_get_param_by_name(effect, "undistort_factor");
+		if (undistort) // newer OBS only
+			gs_effect_set_float(undistort, 1.0f);
+	}
+	while (gs_effect_loop(effect, "Draw"))
+		gs_draw_sprite(tex, 0, ctx->width, ctx->height);
 
 	gs_blend_state_pop();
 	gs_enable_framebuffer_srgb(srgb_prev);
+
+	render_time_add(ctx, os_gettime_ns() - start_ns);
 }
 
 static uint32_t source_get_width(const void *data)
@@ -724,7 +3012,25 @@ static obs_properties_t *source_properties(void *data)
 	obs_properties_add_int(p, "width", "Width", 320, 3840, 1);
 	obs_properties_add_int(p, "height", "Height", 240, 2160, 1);
 	obs_properties_add_int(p, "pixel_ratio", "Pixel Ratio (%)", 25, 400, 5);
+	obs_properties_add_int(p, "render_scale", "Render Resolution (% of Width/Height)", 25, 100, 5);
+	obs_properties_add_bool(p, "bicubic_upscale", "Bicubic Upscaling");
 	obs_properties_add_text(p, "dart_config", "Dart Config (JSON)", OBS_TEXT_MULTILINE);
+	obs_properties_add_bool(p, "release_hidden", "Free Frame Buffers While Hidden");
+	obs_properties_add_bool(p, "shared_engine", "Share Engine With Other Flutter Sources (applies on reload)");
+	obs_properties_add_bool(p, "matte", "Alpha Matte Output, Gray8 (applies on reload)");
+	obs_properties_add_bool(p, "governor", "Lower Quality While OBS Is Overloaded");
+	obs_properties_add_int(p, "governor_min_scale", "Lowest Resolution Under Load (%)", 25, 100, 25);
+	obs_properties_add_int(p, "governor_max_divider", "Lowest Frame Rate Under Load (1/n of OBS)", 1, 4, 1);
+
+	obs_property_t *fft = obs_properties_add_list(p, "analysis_fft_size", "Audio Analysis FFT Size",
+						      OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+	for (int n = 256; n <= 4096; n <<= 1) {
+		char label[16];
+		snprintf(label, sizeof(label), "%d", n);
+		obs_property_list_add_int(fft, label, n);
+	}
+	obs_properties_add_int(p, "analysis_rate", "Audio Analysis Rate (Hz)", 1, 60, 1);
+	obs_properties_add_text(p, "analysis_source", "Audio Analysis Source (OBS source name)", OBS_TEXT_DEFAULT);
 	return p;
 }
 
@@ -733,7 +3039,18 @@ static void flutter_source_defaults(obs_data_t *settings)
 	obs_data_set_default_int(settings, "width", 640);
 	obs_data_set_default_int(settings, "height", 480);
 	obs_data_set_default_int(settings, "pixel_ratio", 100);
-	obs_data_set_default_string(settings, "dart_config", "{\n\t\n}");
+	obs_data_set_default_int(settings, "render_scale", 100);
+	obs_data_set_default_bool(settings, "bicubic_upscale", false);
+	obs_data_set_default_string(settings, "dart_config", DEFAULT_DART_CONFIG);
+	obs_data_set_default_int(settings, "analysis_fft_size", 1024);
+	obs_data_set_default_int(settings, "analysis_rate", 30);
+	obs_data_set_default_string(settings, "analysis_source", "");
+	obs_data_set_default_bool(settings, "release_hidden", false);
+	obs_data_set_default_bool(settings, "shared_engine", false);
+	obs_data_set_default_bool(settings, "matte", false);
+	obs_data_set_default_bool(settings, "governor", false); // opt-in
+	obs_data_set_default_int(settings, "governor_min_scale", 50);
+	obs_data_set_default_int(settings, "governor_max_divider", 2);
 }
 
 static void source_update(void *data, obs_data_t *settings)
@@ -742,9 +3059,17 @@ static void source_update(void *data, obs_data_t *settings)
 	uint32_t w = (uint32_t)obs_data_get_int(settings, "width");
 	uint32_t h = (uint32_t)obs_data_get_int(settings, "height");
 	uint32_t pixel_ratio = (uint32_t)obs_data_get_int(settings, "pixel_ratio");
+	const uint32_t scale = render_scale(settings);
+	const bool governor = obs_data_get_bool(settings, "governor");
+	const uint32_t min_scale = (uint32_t)obs_data_get_int(settings, "governor_min_scale");
+	const uint32_t max_divider = (uint32_t)obs_data_get_int(settings, "governor_max_divider");
 
 	const char *json_str = obs_data_get_string(settings, "dart_config");
 
+	analysis_update(ctx, settings);
+	ctx->release_hidden = obs_data_get_bool(settings, "release_hidden");
+	ctx->bicubic_upscale = obs_data_get_bool(settings, "bicubic_upscale");
+
 	if (!w)
 		w = 320;
 	if (!h)
@@ -752,55 +3077,99 @@ static void source_update(void *data, obs_data_t *settings)
 	if (!pixel_ratio)
 		pixel_ratio = 100;
 
-	const bool resize = w != ctx->width || h != ctx->height || pixel_ratio != ctx->pixel_ratio_pct;
+	/* Config edits are debounced: the text box fires on every keystroke,
+	 * video_tick delivers the latest text once typing pauses. */
+	const char *dart_config = (json_str && json_str[0]) ? json_str : DEFAULT_DART_CONFIG;
+	pt_mutex_lock(&ctx->config_cs);
+	if (strcmp(ctx->config_latest, dart_config) != 0) {
+		bfree(ctx->config_latest);
+		ctx->config_latest = bstrdup(dart_config);
+		pt_atomic_xchg64(&ctx->config_due_ns, (int64_t)(os_gettime_ns() + CONFIG_DEBOUNCE_NS));
+	}
+	pt_mutex_unlock(&ctx->config_cs);
+
+	/* Slider drags call us many times a second; only the latest size is
+	 * kept and video_tick applies it once it has settled. */
+	pt_mutex_lock(&ctx->tex_cs);
+	const bool resize = w != ctx->req_width || h != ctx->req_height || pixel_ratio != ctx->req_ratio_pct ||
+			    scale != ctx->req_render_scale_pct || governor != ctx->req_governor || min_scale != ctx->req_min_scale_pct ||
+			    max_divider != ctx->req_max_divider;
+	ctx->req_width = w;
+	ctx->req_height = h;
+	ctx->req_ratio_pct = pixel_ratio;
+	ctx->req_render_scale_pct = scale;
+	ctx->req_governor = governor;
+	ctx->req_min_scale_pct = min_scale;
+	ctx->req_max_divider = max_divider;
+	pt_mutex_unlock(&ctx->tex_cs);
+
+	if (resize)
+		pt_atomic_xchg64(&ctx->resize_due_ns, (int64_t)(os_gettime_ns() + RESIZE_SETTLE_NS));
+}
 
-	const char *default_json = "{\n\t\n}";
-	const char *dart_config = (json_str && json_str[0]) ? json_str : default_json;
-	const bool config_changed = strncmp(ctx->dart_config, dart_config, sizeof(ctx->dart_config) - 1) != 0;
+/* Graphics thread. */
+static void send_metrics(struct flutter_source *ctx)
+{
+	if (ctx->engine) {
+		FlutterWindowMetricsEvent wm;
+		view_metrics(ctx, &wm);
+		g_embedder.SendWindowMetricsEvent(ctx->engine, &wm);
+		g_embedder.ScheduleFrame(ctx->engine);
+	}
+}
 
-	if (!resize && !config_changed)
+/* Graphics thread, at most once per OBS frame. */
+static void apply_resize(struct flutter_source *ctx)
+{
+	pt_mutex_lock(&ctx->tex_cs);
+	const uint32_t w = ctx->req_width, h = ctx->req_height, pixel_ratio = ctx->req_ratio_pct;
+	const uint32_t scale = ctx->req_render_scale_pct;
+	const bool governor = ctx->req_governor;
+	const uint32_t min_scale = ctx->req_min_scale_pct, max_divider = ctx->req_max_divider;
+	pt_mutex_unlock(&ctx->tex_cs);
+
+	const bool governed = governor_configure(&ctx->governor, governor, min_scale, max_divider);
+	if (!governed && w == ctx->width && h == ctx->height && pixel_ratio == ctx->pixel_ratio_pct &&
+	    scale == ctx->render_scale_pct)
 		return;
 
-	if (resize) {
-		EnterCriticalSection(&ctx->tex_cs);
-		if (ctx->texture)
-			gs_texture_destroy(ctx->texture), ctx->texture = NULL;
-		free(ctx->pixel_data);
+	ctx->width = w;
+	ctx->height = h;
+	ctx->pixel_ratio_pct = pixel_ratio;
+	ctx->render_scale_pct = scale;
+	send_metrics(ctx);
+}
 
-		ctx->width = w;
-		ctx->height = h;
-		ctx->pixel_ratio_pct = pixel_ratio;
+static void source_video_tick(void *data, float seconds)
+{
+	struct flutter_source *ctx = data;
+	const uint64_t now = os_gettime_ns();
 
-		ctx->pixel_data = calloc(ctx->width * ctx->height, 4);
-		LeaveCriticalSection(&ctx->tex_cs);
-	}
+	update_suspension(ctx);
+	if (ctx->started && ctx->host && ctx->engine)
+		host_return_vsync(ctx->host, ctx->engine);
 
-	strncpy(ctx->dart_config, dart_config, sizeof(ctx->dart_config) - 1);
+	const uint64_t resize_due = (uint64_t)ctx->resize_due_ns;
+	if (resize_due && now >= resize_due &&
+	    pt_atomic_cas64(&ctx->resize_due_ns, 0, (int64_t)resize_due) == (int64_t)resize_due)
+		apply_resize(ctx);
 
-	const FlutterPlatformMessageResponseHandle *dummy = NULL;
-	FlutterEngineSendPlatformMessage(ctx->engine,
-					 &(FlutterPlatformMessage){.struct_size = sizeof(FlutterPlatformMessage),
-								   .channel = "obs_config",
-								   .message = (const uint8_t *)ctx->dart_config,
-								   .message_size = (uint32_t)strlen(ctx->dart_config),
-								   .response_handle = dummy});
+	const uint64_t cost_ns = (uint64_t)ctx->render_ns_total + (uint64_t)ctx->present_ns_total;
+	if (governor_tick(&ctx->governor, obs_source_get_name(ctx->source), now, cost_ns))
+		send_metrics(ctx);
 
-	if (ctx->engine) {
-		const FlutterWindowMetricsEvent wm = {
-			.struct_size = sizeof(wm),
-			.width = ctx->width,
-			.height = ctx->height,
-			.pixel_ratio = (float)ctx->pixel_ratio_pct / 100.0f,
-		};
-		FlutterEngineSendWindowMetricsEvent(ctx->engine, &wm);
-		FlutterEngineScheduleFrame(ctx->engine);
+	const uint64_t due = (uint64_t)ctx->config_due_ns;
+	if (due && now >= due &&
+	    pt_atomic_cas64(&ctx->config_due_ns, 0, (int64_t)due) == (int64_t)due) {
+		const command_t cmd = {.type = CMD_SEND_CONFIG, .ctx = ctx};
+		queue_push(&g_queue, &cmd);
 	}
 }
 
 struct obs_source_info flutter_source_info = {
 	.id = "flutter_source",
 	.type = OBS_SOURCE_TYPE_INPUT,
-	.output_flags = OBS_SOURCE_VIDEO | OBS_SOURCE_SRGB | OBS_SOURCE_AUDIO,
+	.output_flags = OBS_SOURCE_VIDEO | OBS_SOURCE_CUSTOM_DRAW | OBS_SOURCE_SRGB | OBS_SOURCE_AUDIO,
 	.get_name = source_get_name,
 	.create = source_create,
 	.destroy = source_destroy,
@@ -809,6 +3178,11 @@ struct obs_source_info flutter_source_info = {
 	.get_width = source_get_width,
 	.get_height = source_get_height,
 	.update = source_update,
+	.video_tick = source_video_tick,
+	.show = source_show,
+	.hide = source_hide,
+	.activate = source_activate,
+	.deactivate = source_deactivate,
 	.get_properties = source_properties,
 	.icon_type = OBS_ICON_TYPE_MEDIA,
 };
@@ -0,0 +1,85 @@
+/*
+ * Direct-call C ABI exported by the OBS Flutter source plug-in.
+ *
+ * Dart binds these with dart:ffi to skip the platform-message round trip
+ * for hot operations.  Open the plug-in module by the path the `obs_ffi`
+ * channel returns for "library": OBS loads plug-ins without RTLD_GLOBAL on
+ * Linux, so `DynamicLibrary.process()` can't see these symbols there.
+ *
+ * Every entry point is thread-safe.  Each takes a shared lock on the handle
+ * table, which is held exclusively only while a source registers or
+ * unregisters, so a call can briefly wait on source creation or
+ * destruction.  A call never waits on another caller using the same
+ * source: it returns OBS_FLUTTER_BUSY instead.
+ *
+ * A source handle is obtained once per engine over the `obs_ffi` channel
+ * (method "handle").  Handles of destroyed sources are never reused, so a
+ * stale handle fails with OBS_FLUTTER_INVALID_HANDLE.
+ *
+ * Commands sent here and over `obs_audio` are applied by the same audio
+ * tick, but there is no ordering guarantee between the two paths.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+#define OBS_FLUTTER_EXPORT __declspec(dllexport)
+#else
+#define OBS_FLUTTER_EXPORT __attribute__((visibility("default")))
+#endif
+
+/* Bumped on any incompatible change; additions only grow the stats struct. */
+#define OBS_FLUTTER_API_VERSION 1
+
+enum obs_flutter_result {
+	OBS_FLUTTER_OK = 0,
+	OBS_FLUTTER_INVALID_HANDLE = -1,
+	OBS_FLUTTER_BUSY = -2,
+	OBS_FLUTTER_QUEUE_FULL = -3,
+	OBS_FLUTTER_INVALID_ARGUMENT = -4,
+};
+
+typedef struct {
+	uint32_t struct_size; // set by the caller to sizeof(obs_flutter_stats)
+	uint32_t width;
+	uint32_t height;
+	uint32_t sounds_loaded;
+	uint64_t frames_presented;
+	uint64_t audio_ticks;
+	uint64_t platform_messages;
+	uint64_t render_calls;    // source_render invocations on the OBS graphics thread
+	uint64_t render_ns_total; // graphics-thread time spent in them
+	uint64_t render_ns_max;
+	uint64_t first_frame_ns; // source creation to first presented frame, 0 until then
+	uint64_t frames_uploaded;       // presented frames that reached a texture (the rest were superseded)
+	uint64_t upload_latency_p50_ns; // engine present -> texture ready to draw
+	uint64_t upload_latency_p99_ns;
+	uint64_t audio_jitter_p99_ns;   // deviation of the 20 ms audio tick period
+	uint64_t present_ns_total;      // engine raster-thread time copying frames
+	uint64_t audio_ns_total;        // audio timer time spent mixing
+	uint32_t governor_scale_pct;    // render resolution under load, 100 = as configured
+	uint32_t governor_frame_divider; // frame rate is OBS fps / this
+	uint64_t governor_changes;      // quality steps taken, down and up
+} obs_flutter_stats;
+
+OBS_FLUTTER_EXPORT uint32_t obs_flutter_api_version(void);
+
+/* Sound ids are 0..255, as on the obs_audio channel.  `asset` is UTF-8 and
+ * relative to flutter_assets unless `absolute` is non-zero. */
+OBS_FLUTTER_EXPORT int32_t obs_flutter_audio_load(int64_t source, int32_t id, const char *asset, int32_t absolute);
+OBS_FLUTTER_EXPORT int32_t obs_flutter_audio_play(int64_t source, int32_t id, float volume, int32_t loop);
+OBS_FLUTTER_EXPORT int32_t obs_flutter_audio_stop(int64_t source, int32_t id);
+OBS_FLUTTER_EXPORT int32_t obs_flutter_audio_volume(int64_t source, int32_t id, float volume);
+
+/* Fills at most `out->struct_size` bytes. */
+OBS_FLUTTER_EXPORT int32_t obs_flutter_get_stats(int64_t source, obs_flutter_stats *out);
+
+#ifdef __cplusplus
+}
+#endif
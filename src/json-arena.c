@@ -0,0 +1,92 @@
+/*
+ * Parse-scoped bump allocator for cJSON.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "json-arena.h"
+#include "./third_party/cjson/cJSON.h"
+
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+#define ARENA_ALIGN 16
+
+struct arena {
+	uint8_t *base; // lazily allocated, JSON_ARENA_SIZE bytes
+	size_t used;
+	bool active;
+	struct json_arena_stats stats;
+};
+
+static THREAD_LOCAL struct arena t_arena;
+
+static void *CJSON_CDECL arena_malloc(size_t size)
+{
+	struct arena *a = &t_arena;
+	if (a->active) {
+		const size_t need = (size + (ARENA_ALIGN - 1)) & ~(size_t)(ARENA_ALIGN - 1);
+		if (a->base && need <= JSON_ARENA_SIZE - a->used) {
+			void *p = a->base + a->used;
+			a->used += need;
+			a->stats.arena_allocs++;
+			return p;
+		}
+		a->stats.heap_allocs++;
+	}
+	return malloc(size);
+}
+
+/* Only the calling thread's arena is recognised: a tree parsed inside a
+ * scope must be deleted on the thread that parsed it, or its nodes would be
+ * handed to free().  The platform thread parses, handles and deletes every
+ * message tree before json_arena_end(), so nothing crosses threads. */
+static void CJSON_CDECL arena_free(void *ptr)
+{
+	const struct arena *a = &t_arena;
+	const uint8_t *p = ptr;
+	if (a->base && p >= a->base && p < a->base + JSON_ARENA_SIZE)
+		return; // reclaimed wholesale by json_arena_end()
+	free(ptr);
+}
+
+void json_arena_install(void)
+{
+	cJSON_Hooks hooks = {
+		.malloc_fn = arena_malloc,
+		.free_fn = arena_free,
+	};
+	cJSON_InitHooks(&hooks);
+}
+
+void json_arena_begin(void)
+{
+	struct arena *a = &t_arena;
+	if (!a->base)
+		a->base = malloc(JSON_ARENA_SIZE);
+	a->used = 0;
+	a->active = true;
+	a->stats.scopes++;
+}
+
+void json_arena_end(void)
+{
+	t_arena.active = false;
+	t_arena.used = 0;
+}
+
+void json_arena_thread_release(void)
+{
+	free(t_arena.base);
+	memset(&t_arena, 0, sizeof(t_arena));
+}
+
+struct json_arena_stats json_arena_thread_stats(void)
+{
+	return t_arena.stats;
+}
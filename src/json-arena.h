@@ -0,0 +1,34 @@
+/*
+ * Parse-scoped bump allocator for cJSON.
+ *
+ * cJSON's hooks are process-wide, but the arena is per thread and only
+ * active between json_arena_begin() and json_arena_end().  Outside that
+ * window (and when a parse outgrows the arena) allocations fall through to
+ * malloc/free, so every other cJSON user in the plug-in is unaffected.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#define JSON_ARENA_SIZE (64 * 1024)
+
+struct json_arena_stats {
+	uint64_t scopes;      // begin/end pairs
+	uint64_t arena_allocs; // served from the arena
+	uint64_t heap_allocs;  // malloc fallbacks while a scope was open
+};
+
+/* Installs the cJSON hooks; call once before any cJSON use. */
+void json_arena_install(void);
+
+void json_arena_begin(void);
+/* Releases everything allocated since json_arena_begin().  All cJSON trees
+ * parsed in the scope must have been deleted by now, on this thread. */
+void json_arena_end(void);
+
+/* Frees the calling thread's arena block (call before the thread exits). */
+void json_arena_thread_release(void);
+
+/* Counters of the calling thread. */
+struct json_arena_stats json_arena_thread_stats(void);
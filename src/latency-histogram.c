@@ -0,0 +1,58 @@
+/*
+ * Fixed-size latency histogram for pipeline instrumentation.
+ */
+
+#include "latency-histogram.h"
+
+static uint32_t bucket_of(uint64_t ns)
+{
+	const uint64_t us = ns / 1000;
+	if (us < 8)
+		return (uint32_t)us;
+
+	uint32_t e = 3; // us >= 2^e
+	while (us >> (e + 1))
+		++e;
+	const uint32_t sub = (uint32_t)(us >> (e - 2)) & 3;
+	const uint32_t index = 8 + (e - 3) * 4 + sub;
+	return index < LATENCY_BUCKETS ? index : LATENCY_BUCKETS - 1;
+}
+
+static uint64_t bucket_upper_ns(uint32_t index)
+{
+	if (index < 8)
+		return (uint64_t)(index + 1) * 1000;
+
+	const uint32_t e = (index - 8) / 4 + 3;
+	const uint32_t sub = (index - 8) % 4;
+	return ((uint64_t)(5 + sub) << (e - 2)) * 1000;
+}
+
+void latency_histogram_add(struct latency_histogram *h, uint64_t ns)
+{
+	h->counts[bucket_of(ns)]++;
+	h->samples++;
+	if (ns > h->max_ns)
+		h->max_ns = ns;
+}
+
+uint64_t latency_histogram_percentile(const struct latency_histogram *h, double p)
+{
+	const uint64_t samples = h->samples;
+	if (!samples)
+		return 0;
+
+	uint64_t rank = (uint64_t)(p * (double)samples);
+	if (rank >= samples)
+		rank = samples - 1;
+
+	uint64_t seen = 0;
+	for (uint32_t i = 0; i < LATENCY_BUCKETS; ++i) {
+		seen += h->counts[i];
+		if (seen > rank) {
+			const uint64_t upper = bucket_upper_ns(i);
+			return upper < h->max_ns ? upper : h->max_ns;
+		}
+	}
+	return h->max_ns;
+}
@@ -0,0 +1,28 @@
+/*
+ * Fixed-size latency histogram for pipeline instrumentation.
+ *
+ * Buckets are log-linear in microseconds: exact below 8 us, then four
+ * buckets per power of two, so percentiles are within 25% up to ~70
+ * minutes.  Adding is a few integer operations and never allocates.
+ *
+ * A histogram has one writer.  Readers on other threads (the FFI stats
+ * call) may see a sample half-added, which only skews a percentile by one
+ * count.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#define LATENCY_BUCKETS 128
+
+struct latency_histogram {
+	uint64_t counts[LATENCY_BUCKETS];
+	uint64_t samples;
+	uint64_t max_ns;
+};
+
+void latency_histogram_add(struct latency_histogram *h, uint64_t ns);
+
+/* Upper bound of the bucket holding the `p` quantile (0..1), 0 if empty. */
+uint64_t latency_histogram_percentile(const struct latency_histogram *h, double p);
@@ -19,19 +19,30 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 #include <obs-module.h>
 #include <plugin-support.h>
 
+#include "json-arena.h"
+#include "texture-pool.h"
+#include "engine-procs.h"
+
 OBS_DECLARE_MODULE()
 OBS_MODULE_USE_DEFAULT_LOCALE(PLUGIN_NAME, "en-US")
 
 extern struct obs_source_info flutter_source_info;
+void flutter_source_free_graphics(void);
 
 bool obs_module_load(void)
 {
 	obs_log(LOG_INFO, "plugin loaded successfully (version %s)", PLUGIN_VERSION);
+	json_arena_install();
 	obs_register_source(&flutter_source_info);
 	return true;
 }
 
 void obs_module_unload(void)
 {
+	obs_enter_graphics();
+	texture_pool_free_all();
+	flutter_source_free_graphics();
+	obs_leave_graphics();
+	embedder_unload();
 	obs_log(LOG_INFO, "plugin unloaded");
 }
@@ -0,0 +1,302 @@
+/*
+ * POSIX (Linux) side of portable.h.
+ */
+
+#define _GNU_SOURCE
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <linux/futex.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "portable.h"
+
+void pt_mutex_init(pt_mutex *m)
+{
+	pthread_mutex_init(m, NULL);
+}
+
+void pt_mutex_destroy(pt_mutex *m)
+{
+	pthread_mutex_destroy(m);
+}
+
+void pt_mutex_lock(pt_mutex *m)
+{
+	pthread_mutex_lock(m);
+}
+
+bool pt_mutex_trylock(pt_mutex *m)
+{
+	return pthread_mutex_trylock(m) == 0;
+}
+
+void pt_mutex_unlock(pt_mutex *m)
+{
+	pthread_mutex_unlock(m);
+}
+
+void pt_rwlock_init(pt_rwlock *l)
+{
+	pthread_rwlock_init(l, NULL);
+}
+
+void pt_rwlock_destroy(pt_rwlock *l)
+{
+	pthread_rwlock_destroy(l);
+}
+
+void pt_rwlock_read_lock(pt_rwlock *l)
+{
+	pthread_rwlock_rdlock(l);
+}
+
+void pt_rwlock_read_unlock(pt_rwlock *l)
+{
+	pthread_rwlock_unlock(l);
+}
+
+void pt_rwlock_write_lock(pt_rwlock *l)
+{
+	pthread_rwlock_wrlock(l);
+}
+
+void pt_rwlock_write_unlock(pt_rwlock *l)
+{
+	pthread_rwlock_unlock(l);
+}
+
+//  ───────────────   futex semaphore   ───────────────
+
+static void futex_wait(volatile uint32_t *word, uint32_t expected)
+{
+	syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+}
+
+static void futex_wake(volatile uint32_t *word, int count)
+{
+	syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+void pt_sem_init(pt_sem *s, uint32_t count)
+{
+	s->count = count;
+	s->waiters = 0;
+}
+
+void pt_sem_destroy(pt_sem *s)
+{
+	(void)s;
+}
+
+void pt_sem_post(pt_sem *s)
+{
+	__atomic_add_fetch(&s->count, 1, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&s->waiters, __ATOMIC_SEQ_CST)) // uncontended posts stay in user space
+		futex_wake(&s->count, 1);
+}
+
+void pt_sem_wait(pt_sem *s)
+{
+	for (;;) {
+		uint32_t c = __atomic_load_n(&s->count, __ATOMIC_SEQ_CST);
+		while (c) {
+			if (__atomic_compare_exchange_n(&s->count, &c, c - 1, true, __ATOMIC_SEQ_CST,
+							__ATOMIC_SEQ_CST))
+				return;
+		}
+		__atomic_add_fetch(&s->waiters, 1, __ATOMIC_SEQ_CST);
+		futex_wait(&s->count, 0); // returns at once if a post got in first
+		__atomic_sub_fetch(&s->waiters, 1, __ATOMIC_SEQ_CST);
+	}
+}
+
+//  ───────────────   threads   ───────────────
+
+struct thread_start {
+	pt_thread_fn fn;
+	void *arg;
+};
+
+static void *thread_main(void *param)
+{
+	struct thread_start start = *(struct thread_start *)param;
+	free(param);
+	start.fn(start.arg);
+	return NULL;
+}
+
+bool pt_thread_create(pt_thread *t, pt_thread_fn fn, void *arg)
+{
+	struct thread_start *start = malloc(sizeof(*start));
+	if (!start)
+		return false;
+	start->fn = fn;
+	start->arg = arg;
+
+	if (pthread_create(t, NULL, thread_main, start) != 0) {
+		free(start);
+		return false;
+	}
+	return true;
+}
+
+void pt_thread_join(pt_thread t)
+{
+	pthread_join(t, NULL);
+}
+
+uint64_t pt_thread_id(void)
+{
+	return (uint64_t)syscall(SYS_gettid);
+}
+
+bool pt_thread_set_priority(int priority)
+{
+	priority = priority < -2 ? -2 : priority > 3 ? 3 : priority;
+	return pt_thread_set_nice(-5 * priority);
+}
+
+bool pt_thread_set_nice(int nice)
+{
+	// With a tid, PRIO_PROCESS applies to that thread only on Linux
+	return setpriority(PRIO_PROCESS, (id_t)pt_thread_id(), nice) == 0;
+}
+
+bool pt_thread_set_affinity(uint64_t mask)
+{
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (int cpu = 0; cpu < 64; ++cpu) {
+		if (mask & (1ULL << cpu))
+			CPU_SET(cpu, &set);
+	}
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+//  ───────────────   timers   ───────────────
+
+/* One thread per timer sleeping until absolute CLOCK_MONOTONIC deadlines,
+ * so periods don't drift with callback time.  The condition variable only
+ * serves to cut the sleep short on stop. */
+struct pt_timer {
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	bool stop;
+	uint32_t period_ms;
+	uint64_t due_ns;
+	pt_thread_fn fn;
+	void *arg;
+};
+
+static uint64_t monotonic_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void *timer_main(void *param)
+{
+	struct pt_timer *t = param;
+	uint64_t next = t->due_ns;
+
+	pthread_mutex_lock(&t->lock);
+	for (;;) {
+		while (!t->stop && monotonic_ns() < next) {
+			const struct timespec ts = {.tv_sec = (time_t)(next / 1000000000ULL),
+						    .tv_nsec = (long)(next % 1000000000ULL)};
+			pthread_cond_timedwait(&t->cond, &t->lock, &ts);
+		}
+		if (t->stop)
+			break;
+		pthread_mutex_unlock(&t->lock);
+
+		t->fn(t->arg);
+
+		pthread_mutex_lock(&t->lock);
+		if (!t->period_ms)
+			break;
+		const uint64_t period_ns = (uint64_t)t->period_ms * 1000000ULL;
+		next += period_ns;
+		const uint64_t now = monotonic_ns();
+		if (next + period_ns < now)
+			next = now; // overran by more than a period: skip, don't burst
+	}
+	pthread_mutex_unlock(&t->lock);
+	return NULL;
+}
+
+pt_timer *pt_timer_start(uint32_t due_ms, uint32_t period_ms, pt_thread_fn fn, void *arg)
+{
+	struct pt_timer *t = calloc(1, sizeof(*t));
+	if (!t)
+		return NULL;
+	t->fn = fn;
+	t->arg = arg;
+	t->period_ms = period_ms;
+	t->due_ns = monotonic_ns() + (uint64_t)due_ms * 1000000ULL;
+
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&t->cond, &attr);
+	pthread_condattr_destroy(&attr);
+	pthread_mutex_init(&t->lock, NULL);
+
+	if (pthread_create(&t->thread, NULL, timer_main, t) != 0) {
+		pthread_cond_destroy(&t->cond);
+		pthread_mutex_destroy(&t->lock);
+		free(t);
+		return NULL;
+	}
+	return t;
+}
+
+void pt_timer_stop(pt_timer *t)
+{
+	if (!t)
+		return;
+
+	pthread_mutex_lock(&t->lock);
+	t->stop = true;
+	pthread_cond_signal(&t->cond);
+	pthread_mutex_unlock(&t->lock);
+	pthread_join(t->thread, NULL);
+
+	pthread_cond_destroy(&t->cond);
+	pthread_mutex_destroy(&t->lock);
+	free(t);
+}
+
+//  ───────────────   modules   ───────────────
+
+bool pt_module_path(char *out, size_t cap)
+{
+	Dl_info info;
+	if (!dladdr((void *)&pt_module_path, &info) || !info.dli_fname)
+		return false;
+
+	const size_t len = strlen(info.dli_fname);
+	if (len >= cap)
+		return false;
+	memcpy(out, info.dli_fname, len + 1);
+	return true;
+}
+
+bool pt_module_dir(char *out, size_t cap)
+{
+	if (!pt_module_path(out, cap))
+		return false;
+
+	char *slash = strrchr(out, '/');
+	*(slash ? slash : out) = '\0';
+	return true;
+}
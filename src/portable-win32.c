@@ -0,0 +1,217 @@
+/*
+ * Win32 side of portable.h.
+ */
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "portable.h"
+
+void pt_mutex_init(pt_mutex *m)
+{
+	InitializeCriticalSection(m);
+}
+
+void pt_mutex_destroy(pt_mutex *m)
+{
+	DeleteCriticalSection(m);
+}
+
+void pt_mutex_lock(pt_mutex *m)
+{
+	EnterCriticalSection(m);
+}
+
+bool pt_mutex_trylock(pt_mutex *m)
+{
+	return TryEnterCriticalSection(m) != 0;
+}
+
+void pt_mutex_unlock(pt_mutex *m)
+{
+	LeaveCriticalSection(m);
+}
+
+void pt_rwlock_init(pt_rwlock *l)
+{
+	InitializeSRWLock(l);
+}
+
+void pt_rwlock_destroy(pt_rwlock *l)
+{
+	(void)l; // SRW locks own no resources
+}
+
+void pt_rwlock_read_lock(pt_rwlock *l)
+{
+	AcquireSRWLockShared(l);
+}
+
+void pt_rwlock_read_unlock(pt_rwlock *l)
+{
+	ReleaseSRWLockShared(l);
+}
+
+void pt_rwlock_write_lock(pt_rwlock *l)
+{
+	AcquireSRWLockExclusive(l);
+}
+
+void pt_rwlock_write_unlock(pt_rwlock *l)
+{
+	ReleaseSRWLockExclusive(l);
+}
+
+void pt_sem_init(pt_sem *s, uint32_t count)
+{
+	*s = CreateSemaphore(NULL, (LONG)count, LONG_MAX, NULL);
+}
+
+void pt_sem_destroy(pt_sem *s)
+{
+	CloseHandle(*s);
+	*s = NULL;
+}
+
+void pt_sem_post(pt_sem *s)
+{
+	ReleaseSemaphore(*s, 1, NULL);
+}
+
+void pt_sem_wait(pt_sem *s)
+{
+	WaitForSingleObject(*s, INFINITE);
+}
+
+struct thread_start {
+	pt_thread_fn fn;
+	void *arg;
+};
+
+static DWORD WINAPI thread_main(LPVOID param)
+{
+	struct thread_start start = *(struct thread_start *)param;
+	free(param);
+	start.fn(start.arg);
+	return 0;
+}
+
+bool pt_thread_create(pt_thread *t, pt_thread_fn fn, void *arg)
+{
+	struct thread_start *start = malloc(sizeof(*start));
+	if (!start)
+		return false;
+	start->fn = fn;
+	start->arg = arg;
+
+	*t = CreateThread(NULL, 0, thread_main, start, 0, NULL);
+	if (!*t) {
+		free(start);
+		return false;
+	}
+	return true;
+}
+
+void pt_thread_join(pt_thread t)
+{
+	WaitForSingleObject(t, INFINITE);
+	CloseHandle(t);
+}
+
+uint64_t pt_thread_id(void)
+{
+	return GetCurrentThreadId();
+}
+
+bool pt_thread_set_priority(int priority)
+{
+	static const int levels[] = {
+		THREAD_PRIORITY_LOWEST,  THREAD_PRIORITY_BELOW_NORMAL, THREAD_PRIORITY_NORMAL,
+		THREAD_PRIORITY_ABOVE_NORMAL, THREAD_PRIORITY_HIGHEST, THREAD_PRIORITY_TIME_CRITICAL,
+	};
+	priority = priority < -2 ? -2 : priority > 3 ? 3 : priority;
+	return SetThreadPriority(GetCurrentThread(), levels[priority + 2]) != 0;
+}
+
+bool pt_thread_set_nice(int nice)
+{
+	const int priority = -nice / 5;
+	return pt_thread_set_priority(priority > 2 ? 2 : priority);
+}
+
+bool pt_thread_set_affinity(uint64_t mask)
+{
+	return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)mask) != 0;
+}
+
+struct pt_timer {
+	HANDLE handle;
+	pt_thread_fn fn;
+	void *arg;
+	volatile long running;
+};
+
+static VOID CALLBACK timer_main(PVOID param, BOOLEAN timed_out)
+{
+	(void)timed_out;
+	struct pt_timer *t = param;
+	// The pool fires the next period even if this one is still running;
+	// that tick is dropped, which is the skip the header promises.
+	if (pt_atomic_cas(&t->running, 1, 0) != 0)
+		return;
+	t->fn(t->arg);
+	pt_atomic_xchg(&t->running, 0);
+}
+
+pt_timer *pt_timer_start(uint32_t due_ms, uint32_t period_ms, pt_thread_fn fn, void *arg)
+{
+	struct pt_timer *t = calloc(1, sizeof(*t));
+	if (!t)
+		return NULL;
+	t->fn = fn;
+	t->arg = arg;
+
+	// WT_EXECUTEINTIMERTHREAD would serialise every timer, so callbacks run on
+	// the pool; WT_EXECUTELONGFUNCTION lets it add a thread rather than stall
+	// other work behind a callback that overruns.
+	if (!CreateTimerQueueTimer(&t->handle, NULL, timer_main, t, due_ms, period_ms,
+				   WT_EXECUTELONGFUNCTION | (period_ms ? 0 : WT_EXECUTEONLYONCE))) {
+		free(t);
+		return NULL;
+	}
+	return t;
+}
+
+void pt_timer_stop(pt_timer *t)
+{
+	if (!t)
+		return;
+	DeleteTimerQueueTimer(NULL, t->handle, INVALID_HANDLE_VALUE);
+	free(t);
+}
+
+bool pt_module_path(char *out, size_t cap)
+{
+	HMODULE self = NULL;
+	if (!GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+				(LPCWSTR)&pt_module_path, &self))
+		return false;
+
+	wchar_t path[MAX_PATH];
+	const DWORD len = GetModuleFileNameW(self, path, MAX_PATH);
+	if (!len || len == MAX_PATH)
+		return false;
+	return WideCharToMultiByte(CP_UTF8, 0, path, -1, out, (int)cap, NULL, NULL) > 0;
+}
+
+bool pt_module_dir(char *out, size_t cap)
+{
+	if (!pt_module_path(out, cap))
+		return false;
+
+	char *slash = strrchr(out, '\\');
+	if (slash)
+		*slash = '\0';
+	return true;
+}
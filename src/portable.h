@@ -0,0 +1,157 @@
+/*
+ * Thin threading, timing and module layer over Win32 and POSIX.
+ *
+ * Only what the source needs, with Win32 semantics where the two differ:
+ * atomics return what the Interlocked* functions return, the mutex is
+ * recursive-free and non-fair, and a timer never runs its callback twice
+ * at once.  On Linux the semaphore is a futex word and timers are a
+ * thread sleeping on CLOCK_MONOTONIC deadlines.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <windows.h>
+
+#define PT_PATH_SEP "\\"
+
+typedef CRITICAL_SECTION pt_mutex;
+typedef SRWLOCK pt_rwlock;
+#define PT_RWLOCK_INIT SRWLOCK_INIT
+typedef HANDLE pt_sem;
+typedef HANDLE pt_thread;
+#else
+#include <limits.h>
+#include <pthread.h>
+
+#define PT_PATH_SEP "/"
+#ifndef MAX_PATH
+#define MAX_PATH PATH_MAX
+#endif
+
+typedef pthread_mutex_t pt_mutex;
+typedef pthread_rwlock_t pt_rwlock;
+#define PT_RWLOCK_INIT PTHREAD_RWLOCK_INITIALIZER
+typedef struct {
+	volatile uint32_t count; // futex word
+	volatile uint32_t waiters;
+} pt_sem;
+typedef pthread_t pt_thread;
+#endif
+
+//  ───────────────   atomics (sequentially consistent)   ───────────────
+
+#ifdef _WIN32
+static inline long pt_atomic_inc(volatile long *p) { return InterlockedIncrement(p); }
+static inline long pt_atomic_dec(volatile long *p) { return InterlockedDecrement(p); }
+static inline long pt_atomic_xchg(volatile long *p, long v) { return InterlockedExchange(p, v); }
+static inline long pt_atomic_cas(volatile long *p, long v, long expected)
+{
+	return InterlockedCompareExchange(p, v, expected);
+}
+static inline int64_t pt_atomic_inc64(volatile int64_t *p) { return InterlockedIncrement64(p); }
+static inline int64_t pt_atomic_add64(volatile int64_t *p, int64_t v) { return InterlockedExchangeAdd64(p, v); }
+static inline int64_t pt_atomic_xchg64(volatile int64_t *p, int64_t v) { return InterlockedExchange64(p, v); }
+static inline int64_t pt_atomic_cas64(volatile int64_t *p, int64_t v, int64_t expected)
+{
+	return InterlockedCompareExchange64(p, v, expected);
+}
+static inline void *pt_atomic_xchg_ptr(void *volatile *p, void *v) { return InterlockedExchangePointer(p, v); }
+static inline void *pt_atomic_cas_ptr(void *volatile *p, void *v, void *expected)
+{
+	return InterlockedCompareExchangePointer(p, v, expected);
+}
+static inline void pt_memory_barrier(void) { MemoryBarrier(); }
+#else
+#define PT_SC __ATOMIC_SEQ_CST
+static inline long pt_atomic_inc(volatile long *p) { return __atomic_add_fetch(p, 1, PT_SC); }
+static inline long pt_atomic_dec(volatile long *p) { return __atomic_sub_fetch(p, 1, PT_SC); }
+static inline long pt_atomic_xchg(volatile long *p, long v) { return __atomic_exchange_n(p, v, PT_SC); }
+static inline long pt_atomic_cas(volatile long *p, long v, long expected)
+{
+	__atomic_compare_exchange_n(p, &expected, v, false, PT_SC, PT_SC);
+	return expected;
+}
+static inline int64_t pt_atomic_inc64(volatile int64_t *p) { return __atomic_add_fetch(p, 1, PT_SC); }
+static inline int64_t pt_atomic_add64(volatile int64_t *p, int64_t v) { return __atomic_fetch_add(p, v, PT_SC); }
+static inline int64_t pt_atomic_xchg64(volatile int64_t *p, int64_t v) { return __atomic_exchange_n(p, v, PT_SC); }
+static inline int64_t pt_atomic_cas64(volatile int64_t *p, int64_t v, int64_t expected)
+{
+	__atomic_compare_exchange_n(p, &expected, v, false, PT_SC, PT_SC);
+	return expected;
+}
+static inline void *pt_atomic_xchg_ptr(void *volatile *p, void *v) { return __atomic_exchange_n(p, v, PT_SC); }
+static inline void *pt_atomic_cas_ptr(void *volatile *p, void *v, void *expected)
+{
+	__atomic_compare_exchange_n(p, &expected, v, false, PT_SC, PT_SC);
+	return expected;
+}
+static inline void pt_memory_barrier(void) { __atomic_thread_fence(PT_SC); }
+#undef PT_SC
+#endif
+
+//  ───────────────   locks   ───────────────
+
+void pt_mutex_init(pt_mutex *m);
+void pt_mutex_destroy(pt_mutex *m);
+void pt_mutex_lock(pt_mutex *m);
+bool pt_mutex_trylock(pt_mutex *m);
+void pt_mutex_unlock(pt_mutex *m);
+
+void pt_rwlock_init(pt_rwlock *l);
+void pt_rwlock_destroy(pt_rwlock *l);
+void pt_rwlock_read_lock(pt_rwlock *l);
+void pt_rwlock_read_unlock(pt_rwlock *l);
+void pt_rwlock_write_lock(pt_rwlock *l);
+void pt_rwlock_write_unlock(pt_rwlock *l);
+
+/* Counting semaphore; also used as a one-shot "done" signal. */
+void pt_sem_init(pt_sem *s, uint32_t count);
+void pt_sem_destroy(pt_sem *s);
+void pt_sem_post(pt_sem *s);
+void pt_sem_wait(pt_sem *s);
+
+//  ───────────────   threads and timers   ───────────────
+
+typedef void (*pt_thread_fn)(void *arg);
+
+bool pt_thread_create(pt_thread *t, pt_thread_fn fn, void *arg);
+void pt_thread_join(pt_thread t); // also releases the handle
+uint64_t pt_thread_id(void);      // of the calling thread
+
+/* Scheduling of the calling thread.  Priorities run from -2 (lowest) to 2
+ * (highest), 3 is time-critical; on Linux priority p is nice -5 * p.
+ * `nice` is the Linux value directly and is rounded to a priority on
+ * Windows.  Raising either on Linux needs CAP_SYS_NICE or RLIMIT_NICE.
+ * `mask` has one bit per CPU (the first 64). */
+bool pt_thread_set_priority(int priority);
+bool pt_thread_set_nice(int nice);
+bool pt_thread_set_affinity(uint64_t mask);
+
+/* Calls `fn` after `due_ms`, then every `period_ms` (0 = once).  Calls never
+ * overlap: periods missed while the callback overran are skipped rather than
+ * queued. */
+typedef struct pt_timer pt_timer;
+pt_timer *pt_timer_start(uint32_t due_ms, uint32_t period_ms, pt_thread_fn fn, void *arg);
+/* Waits for a running callback; must not be called from the callback. */
+void pt_timer_stop(pt_timer *t);
+
+//  ───────────────   modules   ───────────────
+
+/* UTF-8 path of the plug-in binary itself. */
+bool pt_module_path(char *out, size_t cap);
+/* UTF-8 directory of the plug-in binary, without a trailing separator. */
+bool pt_module_dir(char *out, size_t cap);
+
+static inline bool pt_path_is_absolute(const char *path)
+{
+#ifdef _WIN32
+	return (path[0] && path[1] == ':') || path[0] == '\\' || path[0] == '/';
+#else
+	return path[0] == '/';
+#endif
+}
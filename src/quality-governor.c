@@ -0,0 +1,112 @@
+/*
+ * Adaptive quality for a Flutter source while OBS is overloaded.
+ */
+
+#include <string.h>
+
+#include <obs-module.h>
+#include <media-io/video-io.h>
+
+#include "portable.h"
+#include "quality-governor.h"
+
+#define GOVERNOR_WINDOW_NS 1000000000ULL
+#define GOVERNOR_CALM_WINDOWS 5 // calm windows in a row before stepping back up
+
+/* Levels 0..scale_steps lower the scale by 25% each, the ones above raise
+ * the divider at the lowest scale. */
+static int scale_steps(const struct quality_governor *g)
+{
+	return (int)((100 - g->min_scale_pct) / 25);
+}
+
+static int max_level(const struct quality_governor *g)
+{
+	return g->enabled ? scale_steps(g) + (int)g->max_divider - 1 : 0;
+}
+
+static bool set_level(struct quality_governor *g, int level)
+{
+	const int steps = scale_steps(g);
+	const long scale = 100 - 25 * (level < steps ? level : steps);
+	const long divider = level > steps ? 1 + level - steps : 1;
+
+	g->level = level;
+	if (scale == g->scale_pct && divider == g->divider)
+		return false;
+	pt_atomic_xchg(&g->scale_pct, scale);
+	pt_atomic_xchg(&g->divider, divider);
+	g->changes++;
+	return true;
+}
+
+void governor_init(struct quality_governor *g)
+{
+	memset(g, 0, sizeof(*g));
+	g->min_scale_pct = 100;
+	g->max_divider = 1;
+	g->scale_pct = 100;
+	g->divider = 1;
+}
+
+bool governor_configure(struct quality_governor *g, bool enabled, uint32_t min_scale_pct, uint32_t max_divider)
+{
+	g->enabled = enabled;
+	g->min_scale_pct = min_scale_pct < 25 ? 25 : min_scale_pct > 100 ? 100 : min_scale_pct / 25 * 25;
+	g->max_divider = max_divider < 1 ? 1 : max_divider > 4 ? 4 : max_divider;
+	g->calm_windows = 0;
+
+	const int top = max_level(g);
+	return set_level(g, g->level > top ? top : g->level);
+}
+
+bool governor_tick(struct quality_governor *g, const char *name, uint64_t now_ns, uint64_t cost_ns)
+{
+	g->window_frames++;
+	if (g->window_start_ns && now_ns - g->window_start_ns < GOVERNOR_WINDOW_NS)
+		return false;
+
+	const uint32_t lagged = obs_get_lagged_frames();
+	video_t *video = obs_get_video();
+	const uint32_t skipped = video ? video_output_get_skipped_frames(video) : 0;
+	const uint64_t interval_ns = obs_get_frame_interval_ns();
+	const uint64_t render_ns = obs_get_average_frame_time_ns();
+	const uint64_t own_ns = (cost_ns - g->last_cost_ns) / g->window_frames;
+
+	const bool first = !g->window_start_ns;
+	const uint32_t new_lagged = lagged - g->last_lagged;
+	const uint32_t new_skipped = skipped - g->last_skipped;
+	g->window_start_ns = now_ns;
+	g->window_frames = 0;
+	g->last_lagged = lagged;
+	g->last_skipped = skipped;
+	g->last_cost_ns = cost_ns;
+	if (first || !g->enabled || !interval_ns)
+		return false;
+
+	const bool pressure = new_lagged || new_skipped || render_ns > interval_ns * 9 / 10 || own_ns > interval_ns / 2;
+	const bool calm = !pressure && render_ns < interval_ns * 6 / 10 && own_ns < interval_ns / 4;
+
+	int level = g->level;
+	if (pressure) {
+		g->calm_windows = 0;
+		if (level < max_level(g))
+			level++;
+	} else if (!calm) {
+		g->calm_windows = 0;
+	} else if (++g->calm_windows >= GOVERNOR_CALM_WINDOWS && level > 0) {
+		g->calm_windows = 0;
+		level--;
+	}
+
+	const bool lowered = level > g->level;
+	if (level == g->level || !set_level(g, level))
+		return false;
+
+	blog(LOG_INFO,
+	     "[FlutterSource] '%s' quality %s: %ld%% resolution, 1/%ld frame rate "
+	     "(lagged %u, skipped %u, OBS render %.1f ms, source %.1f ms of %.1f ms)",
+	     name, lowered ? "lowered" : "restored", g->scale_pct, g->divider, new_lagged, new_skipped,
+	     (double)render_ns / 1e6, (double)own_ns / 1e6, (double)interval_ns / 1e6);
+	return true;
+}
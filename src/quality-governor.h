@@ -0,0 +1,50 @@
+/*
+ * Adaptive quality for a Flutter source while OBS is overloaded.
+ *
+ * Once a second the governor looks at OBS's health (frames lagged by the
+ * renderer, frames skipped by the encoders, average render time against
+ * the frame budget) and at what the source itself costs per frame.  Under
+ * pressure it steps down a ladder: first the resolution the engine renders
+ * at, in quarters of the configured pixel ratio, then the frame rate, as a
+ * divider of OBS's.  It only climbs back after several calm seconds in a
+ * row, so a borderline load doesn't make the overlay flicker between
+ * qualities.
+ *
+ * Graphics thread only, apart from the published scale and divider.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct quality_governor {
+	/* configuration, per source */
+	bool enabled;
+	uint32_t min_scale_pct; // lowest render scale, 25..100
+	uint32_t max_divider;   // lowest frame rate, as OBS fps / n
+
+	/* current step; scale and divider are read by other threads */
+	int level;
+	volatile long scale_pct;
+	volatile long divider;
+	uint64_t changes;
+
+	/* sampling window */
+	uint64_t window_start_ns;
+	uint64_t window_frames;
+	uint32_t last_lagged;
+	uint32_t last_skipped;
+	uint64_t last_cost_ns;
+	int calm_windows;
+};
+
+void governor_init(struct quality_governor *g);
+
+/* Returns true when the new limits changed the current step. */
+bool governor_configure(struct quality_governor *g, bool enabled, uint32_t min_scale_pct, uint32_t max_divider);
+
+/* Once per OBS frame; `name` is for the log.  `cost_ns` is the source's
+ * running total of CPU time spent on its frames.  Returns true when scale
+ * or divider changed. */
+bool governor_tick(struct quality_governor *g, const char *name, uint64_t now_ns, uint64_t cost_ns);
@@ -0,0 +1,373 @@
+/*
+ * Allocation-free reader/writer for Flutter's StandardMessageCodec.
+ *
+ * Wire format (little-endian): a type byte, then the payload.  Sizes use
+ * one byte below 254, 254 + uint16 or 255 + uint32.  float64 and typed
+ * lists are aligned to their element size relative to the message start.
+ */
+
+#include <string.h>
+
+#include "standard-codec.h"
+
+#define SMC_MAX_DEPTH 32
+
+//  ───────────────   reader   ───────────────
+
+static bool fail(struct smc_reader *r)
+{
+	r->error = true;
+	return false;
+}
+
+static bool need(struct smc_reader *r, size_t n)
+{
+	if (r->error || n > r->size - r->pos)
+		return fail(r);
+	return true;
+}
+
+static bool read_u8(struct smc_reader *r, uint8_t *out)
+{
+	if (!need(r, 1))
+		return false;
+	*out = r->buf[r->pos++];
+	return true;
+}
+
+static bool read_bytes(struct smc_reader *r, void *out, size_t n)
+{
+	if (!need(r, n))
+		return false;
+	memcpy(out, r->buf + r->pos, n);
+	r->pos += n;
+	return true;
+}
+
+static bool align(struct smc_reader *r, size_t alignment)
+{
+	const size_t mod = r->pos % alignment;
+	if (!mod)
+		return true;
+	if (!need(r, alignment - mod))
+		return false;
+	r->pos += alignment - mod;
+	return true;
+}
+
+static bool read_size(struct smc_reader *r, uint32_t *out)
+{
+	uint8_t b;
+	if (!read_u8(r, &b))
+		return false;
+	if (b < 254) {
+		*out = b;
+		return true;
+	}
+	if (b == 254) {
+		uint16_t v;
+		if (!read_bytes(r, &v, sizeof(v)))
+			return false;
+		*out = v;
+		return true;
+	}
+	return read_bytes(r, out, sizeof(*out));
+}
+
+static bool read_typed(struct smc_reader *r, struct smc_value *out, size_t elem)
+{
+	uint32_t count;
+	if (!read_size(r, &count))
+		return false;
+	if (elem > 1 && !align(r, elem))
+		return false;
+	if ((uint64_t)count * elem > r->size - r->pos)
+		return fail(r);
+	out->data.ptr = r->buf + r->pos;
+	out->data.count = count;
+	r->pos += (size_t)count * elem;
+	return true;
+}
+
+bool smc_read_value(struct smc_reader *r, struct smc_value *out)
+{
+	uint8_t type;
+	if (!read_u8(r, &type))
+		return false;
+
+	memset(out, 0, sizeof(*out));
+	out->type = (enum smc_type)type;
+
+	switch (type) {
+	case SMC_NULL:
+		return true;
+	case SMC_TRUE:
+	case SMC_FALSE:
+		out->b = type == SMC_TRUE;
+		return true;
+	case SMC_INT32: {
+		int32_t v;
+		if (!read_bytes(r, &v, sizeof(v)))
+			return false;
+		out->i = v;
+		return true;
+	}
+	case SMC_INT64:
+		return read_bytes(r, &out->i, sizeof(out->i));
+	case SMC_FLOAT64:
+		return align(r, 8) && read_bytes(r, &out->d, sizeof(out->d));
+	case SMC_LARGE_INT:
+	case SMC_STRING:
+	case SMC_UINT8_LIST:
+		return read_typed(r, out, 1);
+	case SMC_INT32_LIST:
+	case SMC_FLOAT32_LIST:
+		return read_typed(r, out, 4);
+	case SMC_INT64_LIST:
+	case SMC_FLOAT64_LIST:
+		return read_typed(r, out, 8);
+	case SMC_LIST:
+	case SMC_MAP:
+		if (!read_size(r, &out->children.count))
+			return false;
+		/* every child takes at least one byte: reject absurd counts early */
+		if ((uint64_t)out->children.count * (type == SMC_MAP ? 2 : 1) > r->size - r->pos)
+			return fail(r);
+		out->children.first = r->pos;
+		return true;
+	default:
+		return fail(r);
+	}
+}
+
+static bool skip_depth(struct smc_reader *r, int depth)
+{
+	struct smc_value v;
+	if (depth > SMC_MAX_DEPTH)
+		return fail(r);
+	if (!smc_read_value(r, &v))
+		return false;
+	if (v.type != SMC_LIST && v.type != SMC_MAP)
+		return true;
+
+	const uint64_t children = (uint64_t)v.children.count * (v.type == SMC_MAP ? 2 : 1);
+	for (uint64_t i = 0; i < children; ++i) {
+		if (!skip_depth(r, depth + 1))
+			return false;
+	}
+	return true;
+}
+
+bool smc_skip_value(struct smc_reader *r)
+{
+	return skip_depth(r, 0);
+}
+
+bool smc_map_find(const struct smc_reader *r, const struct smc_value *map, const char *key, struct smc_value *out)
+{
+	if (map->type != SMC_MAP)
+		return false;
+
+	struct smc_reader it = *r;
+	smc_enter(&it, map);
+
+	for (uint32_t i = 0; i < map->children.count; ++i) {
+		struct smc_value k;
+		const size_t key_pos = it.pos;
+		if (!smc_read_value(&it, &k))
+			return false;
+		if (k.type == SMC_LIST || k.type == SMC_MAP) {
+			it.pos = key_pos;
+			if (!smc_skip_value(&it))
+				return false;
+		} else if (smc_value_is_string(&k, key)) {
+			return smc_read_value(&it, out);
+		}
+		if (!smc_skip_value(&it))
+			return false;
+	}
+	return false;
+}
+
+bool smc_value_is_string(const struct smc_value *v, const char *s)
+{
+	const size_t len = strlen(s);
+	return v->type == SMC_STRING && v->data.count == len && memcmp(v->data.ptr, s, len) == 0;
+}
+
+bool smc_value_as_int(const struct smc_value *v, int64_t *out)
+{
+	if (v->type != SMC_INT32 && v->type != SMC_INT64)
+		return false;
+	*out = v->i;
+	return true;
+}
+
+bool smc_value_as_double(const struct smc_value *v, double *out)
+{
+	if (v->type == SMC_FLOAT64) {
+		*out = v->d;
+		return true;
+	}
+	if (v->type == SMC_INT32 || v->type == SMC_INT64) {
+		*out = (double)v->i;
+		return true;
+	}
+	return false;
+}
+
+bool smc_value_copy_string(const struct smc_value *v, char *dst, size_t cap)
+{
+	if (v->type != SMC_STRING || !cap)
+		return false;
+	size_t n = v->data.count;
+	if (n >= cap)
+		n = cap - 1;
+	memcpy(dst, v->data.ptr, n);
+	dst[n] = '\0';
+	return true;
+}
+
+bool smc_read_method_call(struct smc_reader *r, struct smc_value *method, struct smc_value *args)
+{
+	if (!smc_read_value(r, method) || method->type != SMC_STRING)
+		return false;
+	if (r->pos == r->size) { // arguments omitted
+		memset(args, 0, sizeof(*args));
+		args->type = SMC_NULL;
+		return true;
+	}
+	return smc_read_value(r, args);
+}
+
+//  ───────────────   writer   ───────────────
+
+static void put(struct smc_writer *w, const void *data, size_t n)
+{
+	if (w->overflow || n > w->cap - w->pos) {
+		w->overflow = true;
+		return;
+	}
+	memcpy(w->buf + w->pos, data, n);
+	w->pos += n;
+}
+
+static void put_u8(struct smc_writer *w, uint8_t b)
+{
+	put(w, &b, 1);
+}
+
+static void put_align(struct smc_writer *w, size_t alignment)
+{
+	static const uint8_t zeros[8] = {0};
+	const size_t mod = w->pos % alignment;
+	if (mod)
+		put(w, zeros, alignment - mod);
+}
+
+static void put_size(struct smc_writer *w, size_t size)
+{
+	if (size < 254) {
+		put_u8(w, (uint8_t)size);
+	} else if (size <= 0xffff) {
+		const uint16_t v = (uint16_t)size;
+		put_u8(w, 254);
+		put(w, &v, sizeof(v));
+	} else {
+		const uint32_t v = (uint32_t)size;
+		put_u8(w, 255);
+		put(w, &v, sizeof(v));
+	}
+}
+
+void smc_write_null(struct smc_writer *w)
+{
+	put_u8(w, SMC_NULL);
+}
+
+void smc_write_bool(struct smc_writer *w, bool v)
+{
+	put_u8(w, v ? SMC_TRUE : SMC_FALSE);
+}
+
+void smc_write_int(struct smc_writer *w, int64_t v)
+{
+	if (v >= INT32_MIN && v <= INT32_MAX) {
+		const int32_t v32 = (int32_t)v;
+		put_u8(w, SMC_INT32);
+		put(w, &v32, sizeof(v32));
+	} else {
+		put_u8(w, SMC_INT64);
+		put(w, &v, sizeof(v));
+	}
+}
+
+void smc_write_double(struct smc_writer *w, double v)
+{
+	put_u8(w, SMC_FLOAT64);
+	put_align(w, 8);
+	put(w, &v, sizeof(v));
+}
+
+void smc_write_string_n(struct smc_writer *w, const char *s, size_t len)
+{
+	put_u8(w, SMC_STRING);
+	put_size(w, len);
+	put(w, s, len);
+}
+
+void smc_write_string(struct smc_writer *w, const char *s)
+{
+	smc_write_string_n(w, s, strlen(s));
+}
+
+void smc_write_uint8_list(struct smc_writer *w, const uint8_t *data, size_t count)
+{
+	put_u8(w, SMC_UINT8_LIST);
+	put_size(w, count);
+	put(w, data, count);
+}
+
+void smc_write_float32_list(struct smc_writer *w, const float *data, size_t count)
+{
+	put_u8(w, SMC_FLOAT32_LIST);
+	put_size(w, count);
+	put_align(w, 4);
+	put(w, data, count * sizeof(float));
+}
+
+void smc_write_float64_list(struct smc_writer *w, const double *data, size_t count)
+{
+	put_u8(w, SMC_FLOAT64_LIST);
+	put_size(w, count);
+	put_align(w, 8);
+	put(w, data, count * sizeof(double));
+}
+
+void smc_write_list_header(struct smc_writer *w, uint32_t count)
+{
+	put_u8(w, SMC_LIST);
+	put_size(w, count);
+}
+
+void smc_write_map_header(struct smc_writer *w, uint32_t entries)
+{
+	put_u8(w, SMC_MAP);
+	put_size(w, entries);
+}
+
+void smc_write_success_envelope(struct smc_writer *w)
+{
+	put_u8(w, 0);
+}
+
+void smc_write_error_envelope(struct smc_writer *w, const char *code, const char *message)
+{
+	put_u8(w, 1);
+	smc_write_string(w, code);
+	if (message)
+		smc_write_string(w, message);
+	else
+		smc_write_null(w);
+	smc_write_null(w); // details
+}
@@ -0,0 +1,125 @@
+/*
+ * Allocation-free reader/writer for Flutter's StandardMessageCodec and the
+ * StandardMethodCodec envelope built on top of it.
+ *
+ * The reader never copies: strings and typed arrays are returned as
+ * pointers into the message, lists and maps as a count plus the offset of
+ * their first child.  Every read is bounds-checked; a malformed message
+ * sets `error` and makes all further reads fail.
+ *
+ * The writer serialises into a caller-provided buffer and sets `overflow`
+ * instead of growing it.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+enum smc_type {
+	SMC_NULL = 0,
+	SMC_TRUE = 1,
+	SMC_FALSE = 2,
+	SMC_INT32 = 3,
+	SMC_INT64 = 4,
+	SMC_LARGE_INT = 5, // hex string, legacy
+	SMC_FLOAT64 = 6,
+	SMC_STRING = 7,
+	SMC_UINT8_LIST = 8,
+	SMC_INT32_LIST = 9,
+	SMC_INT64_LIST = 10,
+	SMC_FLOAT64_LIST = 11,
+	SMC_LIST = 12,
+	SMC_MAP = 13,
+	SMC_FLOAT32_LIST = 14,
+};
+
+struct smc_reader {
+	const uint8_t *buf;
+	size_t size;
+	size_t pos;
+	bool error;
+};
+
+struct smc_value {
+	enum smc_type type;
+	union {
+		bool b;
+		int64_t i;
+		double d;
+		struct {
+			const void *ptr; // in place, element-aligned for typed lists
+			uint32_t count;  // bytes for strings, elements for typed lists
+		} data;
+		struct {
+			uint32_t count; // elements (list) or entries (map)
+			size_t first;   // offset of the first child
+		} children;
+	};
+};
+
+static inline void smc_reader_init(struct smc_reader *r, const uint8_t *buf, size_t size)
+{
+	r->buf = buf;
+	r->size = size;
+	r->pos = 0;
+	r->error = false;
+}
+
+/* Reads the value at the cursor.  For lists and maps the cursor moves to the
+ * first child; use smc_skip_value() to step over a whole value instead. */
+bool smc_read_value(struct smc_reader *r, struct smc_value *out);
+bool smc_skip_value(struct smc_reader *r);
+
+/* Positions `r` on the first child of a list or map read from it. */
+static inline void smc_enter(struct smc_reader *r, const struct smc_value *container)
+{
+	r->pos = container->children.first;
+}
+
+/* Looks up a string key in a map without moving `r`. */
+bool smc_map_find(const struct smc_reader *r, const struct smc_value *map, const char *key, struct smc_value *out);
+
+bool smc_value_is_string(const struct smc_value *v, const char *s);
+bool smc_value_as_int(const struct smc_value *v, int64_t *out); // int32/int64
+bool smc_value_as_double(const struct smc_value *v, double *out); // float64 or int
+/* Copies a string value into `dst` (always terminated); false if not a string. */
+bool smc_value_copy_string(const struct smc_value *v, char *dst, size_t cap);
+
+/* StandardMethodCodec call: method name (string) followed by arguments. */
+bool smc_read_method_call(struct smc_reader *r, struct smc_value *method, struct smc_value *args);
+
+//  ───────────────   writer   ───────────────
+
+struct smc_writer {
+	uint8_t *buf;
+	size_t cap;
+	size_t pos;
+	bool overflow;
+};
+
+static inline void smc_writer_init(struct smc_writer *w, uint8_t *buf, size_t cap)
+{
+	w->buf = buf;
+	w->cap = cap;
+	w->pos = 0;
+	w->overflow = false;
+}
+
+void smc_write_null(struct smc_writer *w);
+void smc_write_bool(struct smc_writer *w, bool v);
+void smc_write_int(struct smc_writer *w, int64_t v); // picks int32 when it fits
+void smc_write_double(struct smc_writer *w, double v);
+void smc_write_string(struct smc_writer *w, const char *s);
+void smc_write_string_n(struct smc_writer *w, const char *s, size_t len);
+void smc_write_uint8_list(struct smc_writer *w, const uint8_t *data, size_t count);
+void smc_write_float32_list(struct smc_writer *w, const float *data, size_t count);
+void smc_write_float64_list(struct smc_writer *w, const double *data, size_t count);
+void smc_write_list_header(struct smc_writer *w, uint32_t count);
+void smc_write_map_header(struct smc_writer *w, uint32_t entries);
+
+/* StandardMethodCodec envelopes.  A success envelope is followed by exactly
+ * one value written by the caller. */
+void smc_write_success_envelope(struct smc_writer *w);
+void smc_write_error_envelope(struct smc_writer *w, const char *code, const char *message);
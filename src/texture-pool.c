@@ -0,0 +1,123 @@
+/*
+ * Graphics-thread texture pool shared by all Flutter sources.
+ */
+
+#include "texture-pool.h"
+
+struct pool_entry {
+	gs_texture_t *tex; // NULL for a free slot
+	uint32_t width, height;
+	enum gs_color_format format;
+	size_t bytes;
+	uint64_t released_at; // pool clock, for LRU
+};
+
+static struct {
+	struct pool_entry slots[TEXTURE_POOL_SLOTS];
+	size_t bytes;
+	uint64_t clock;
+
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t evictions;
+} g_pool;
+
+static size_t texture_bytes(uint32_t width, uint32_t height, enum gs_color_format format)
+{
+	return (size_t)width * height * gs_get_format_bpp(format) / 8;
+}
+
+static void evict(struct pool_entry *e)
+{
+	gs_texture_destroy(e->tex);
+	g_pool.bytes -= e->bytes;
+	g_pool.evictions++;
+	e->tex = NULL;
+}
+
+static struct pool_entry *oldest(void)
+{
+	struct pool_entry *found = NULL;
+	for (int i = 0; i < TEXTURE_POOL_SLOTS; ++i) {
+		struct pool_entry *e = &g_pool.slots[i];
+		if (e->tex && (!found || e->released_at < found->released_at))
+			found = e;
+	}
+	return found;
+}
+
+gs_texture_t *texture_pool_acquire(uint32_t width, uint32_t height, enum gs_color_format format)
+{
+	struct pool_entry *match = NULL;
+	for (int i = 0; i < TEXTURE_POOL_SLOTS; ++i) {
+		struct pool_entry *e = &g_pool.slots[i];
+		if (e->tex && e->width == width && e->height == height && e->format == format &&
+		    (!match || e->released_at > match->released_at))
+			match = e;
+	}
+
+	if (match) {
+		gs_texture_t *tex = match->tex;
+		g_pool.bytes -= match->bytes;
+		g_pool.hits++;
+		match->tex = NULL;
+		return tex;
+	}
+
+	g_pool.misses++;
+	return gs_texture_create(width, height, format, 1, NULL, GS_DYNAMIC);
+}
+
+void texture_pool_release(gs_texture_t *tex)
+{
+	if (!tex)
+		return;
+
+	const uint32_t width = gs_texture_get_width(tex);
+	const uint32_t height = gs_texture_get_height(tex);
+	const enum gs_color_format format = gs_texture_get_color_format(tex);
+	const size_t bytes = texture_bytes(width, height, format);
+
+	if (bytes > TEXTURE_POOL_BUDGET) {
+		gs_texture_destroy(tex);
+		g_pool.evictions++;
+		return;
+	}
+
+	struct pool_entry *slot = NULL;
+	for (int i = 0; i < TEXTURE_POOL_SLOTS && !slot; ++i) {
+		if (!g_pool.slots[i].tex)
+			slot = &g_pool.slots[i];
+	}
+	if (!slot) {
+		slot = oldest();
+		evict(slot);
+	}
+	while (g_pool.bytes + bytes > TEXTURE_POOL_BUDGET)
+		evict(oldest());
+
+	*slot = (struct pool_entry){
+		.tex = tex,
+		.width = width,
+		.height = height,
+		.format = format,
+		.bytes = bytes,
+		.released_at = ++g_pool.clock,
+	};
+	g_pool.bytes += bytes;
+}
+
+void texture_pool_free_all(void)
+{
+	for (int i = 0; i < TEXTURE_POOL_SLOTS; ++i) {
+		if (g_pool.slots[i].tex) {
+			gs_texture_destroy(g_pool.slots[i].tex);
+			g_pool.slots[i].tex = NULL;
+		}
+	}
+	g_pool.bytes = 0;
+
+	blog(LOG_INFO, "[FlutterSource] texture pool: %llu hits, %llu misses, %llu evictions",
+	     (unsigned long long)g_pool.hits, (unsigned long long)g_pool.misses,
+	     (unsigned long long)g_pool.evictions);
+}
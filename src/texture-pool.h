@@ -0,0 +1,32 @@
+/*
+ * Graphics-thread texture pool shared by all Flutter sources.
+ *
+ * Released textures are kept, keyed by (width, height, format), and handed
+ * out again instead of creating new ones, so resizes back and forth and
+ * scene switches that recreate sources do not churn GPU allocations.
+ * Pooled memory is bounded; the least recently released texture goes
+ * first.
+ *
+ * Every call must be made inside the graphics context (source_render,
+ * video_render or between obs_enter_graphics()/obs_leave_graphics()),
+ * which also serialises access to the pool.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <obs-module.h>
+#include <graphics/graphics.h>
+
+#define TEXTURE_POOL_SLOTS 16
+#define TEXTURE_POOL_BUDGET (128u * 1024 * 1024) // bytes of idle textures kept
+
+/* A dynamic texture of the given size, recycled when possible. */
+gs_texture_t *texture_pool_acquire(uint32_t width, uint32_t height, enum gs_color_format format);
+
+/* Returns a texture to the pool (may destroy it or evict older ones). */
+void texture_pool_release(gs_texture_t *tex);
+
+/* Destroys every pooled texture and logs the counters (module unload). */
+void texture_pool_free_all(void);
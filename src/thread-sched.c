@@ -0,0 +1,127 @@
+/*
+ * Priority and CPU affinity per class of thread.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "portable.h"
+#include "thread-sched.h"
+
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+struct thread_sched {
+	bool configured;
+	bool has_priority;
+	bool has_nice; // takes precedence over priority
+	int priority;
+	int nice;
+	uint64_t affinity; // 0 = leave as is
+};
+
+static const char *const class_names[THREAD_CLASS_COUNT] = {"worker", "audio", "ui", "raster", "background"};
+
+static struct thread_sched g_classes[THREAD_CLASS_COUNT];
+static volatile long g_warned[THREAD_CLASS_COUNT];
+static THREAD_LOCAL int t_entered = -1; // class the calling thread last entered
+
+void thread_sched_load(obs_data_t *threads)
+{
+	memset(g_classes, 0, sizeof(g_classes));
+	if (!threads)
+		return;
+
+	for (int i = 0; i < THREAD_CLASS_COUNT; ++i) {
+		obs_data_t *cfg = obs_data_get_obj(threads, class_names[i]);
+		if (!cfg)
+			continue;
+
+		struct thread_sched *s = &g_classes[i];
+		s->has_priority = obs_data_has_user_value(cfg, "priority");
+		s->priority = (int)obs_data_get_int(cfg, "priority");
+		s->has_nice = obs_data_has_user_value(cfg, "nice");
+		s->nice = (int)obs_data_get_int(cfg, "nice");
+		// a string so that masks can be written in hex
+		s->affinity = strtoull(obs_data_get_string(cfg, "affinity"), NULL, 0);
+		s->configured = s->has_priority || s->has_nice || s->affinity;
+		obs_data_release(cfg);
+
+		if (s->configured)
+			blog(LOG_INFO, "[FlutterSource] %s threads: priority %s%d, affinity 0x%llx", class_names[i],
+			     s->has_nice ? "nice " : "", s->has_nice ? s->nice : s->priority,
+			     (unsigned long long)s->affinity);
+	}
+}
+
+bool thread_sched_engine_configured(void)
+{
+	return g_classes[THREAD_CLASS_UI].configured || g_classes[THREAD_CLASS_RASTER].configured ||
+	       g_classes[THREAD_CLASS_BACKGROUND].configured;
+}
+
+void thread_sched_apply(enum thread_class cls)
+{
+	const struct thread_sched *s = &g_classes[cls];
+	t_entered = cls;
+	if (!s->configured)
+		return;
+
+	bool ok = true;
+	if (s->has_nice)
+		ok &= pt_thread_set_nice(s->nice);
+	else if (s->has_priority)
+		ok &= pt_thread_set_priority(s->priority);
+	if (s->affinity)
+		ok &= pt_thread_set_affinity(s->affinity);
+
+	// Typically missing CAP_SYS_NICE on Linux; once per class is enough
+	if (!ok && !pt_atomic_xchg(&g_warned[cls], 1))
+		blog(LOG_WARNING, "[FlutterSource] couldn't apply the %s thread settings (tid %llu)", class_names[cls],
+		     (unsigned long long)pt_thread_id());
+}
+
+void thread_sched_enter(enum thread_class cls)
+{
+	if (t_entered != (int)cls)
+		thread_sched_apply(cls);
+}
+
+void thread_sched_priority_setter(FlutterThreadPriority priority)
+{
+	switch (priority) {
+	case kBackground:
+		thread_sched_apply(THREAD_CLASS_BACKGROUND);
+		break;
+	case kDisplay:
+		thread_sched_apply(THREAD_CLASS_UI);
+		break;
+	case kRaster:
+		thread_sched_apply(THREAD_CLASS_RASTER);
+		break;
+	case kNormal:
+		break;
+	}
+}
+
+void thread_sched_native_thread_cb(FlutterNativeThreadType type, void *user_data)
+{
+	(void)user_data;
+	switch (type) {
+	case kFlutterNativeThreadTypePlatform:
+		thread_sched_enter(THREAD_CLASS_WORKER);
+		break;
+	case kFlutterNativeThreadTypeRender:
+		thread_sched_enter(THREAD_CLASS_RASTER);
+		break;
+	case kFlutterNativeThreadTypeUI:
+		thread_sched_enter(THREAD_CLASS_UI);
+		break;
+	case kFlutterNativeThreadTypeWorker:
+		thread_sched_enter(THREAD_CLASS_BACKGROUND);
+		break;
+	}
+}
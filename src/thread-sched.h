@@ -0,0 +1,52 @@
+/*
+ * Priority and CPU affinity per class of thread.
+ *
+ * Classes cover the plug-in's own threads (the worker that doubles as the
+ * engines' platform thread, the audio timers, sound decoders) and the
+ * threads the engine creates.  Engine threads are configured twice: through
+ * FlutterCustomTaskRunners.thread_priority_setter as the engine creates its
+ * UI, raster and IO threads, and through
+ * FlutterEnginePostCallbackOnAllNativeThreads once an engine runs, which
+ * also reaches the shared Dart worker pool.
+ *
+ * Unconfigured classes are left at the OS defaults.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#include <obs-module.h>
+
+#include "flutter_embedder.h"
+
+enum thread_class {
+	THREAD_CLASS_WORKER,     // plug-in worker / engine platform thread
+	THREAD_CLASS_AUDIO,      // audio mixing timers
+	THREAD_CLASS_UI,         // engine UI (Dart root isolate) threads
+	THREAD_CLASS_RASTER,     // engine raster threads
+	THREAD_CLASS_BACKGROUND, // engine IO and Dart workers, sound decoders
+	THREAD_CLASS_COUNT,
+};
+
+/* Reads the "threads" object of the module settings (NULL clears all):
+ *   {"raster": {"priority": 2, "affinity": "0x0c"}, "background": {"nice": 10}}
+ * Must run before any thread applies its class. */
+void thread_sched_load(obs_data_t *threads);
+
+/* True when any engine-created class is configured, i.e. posting to the
+ * engine's native threads is worth it. */
+bool thread_sched_engine_configured(void);
+
+/* Applies `cls` to the calling thread. */
+void thread_sched_apply(enum thread_class cls);
+
+/* As thread_sched_apply(), but only the first time a thread enters `cls`;
+ * for callbacks on pooled threads that can't be configured at creation. */
+void thread_sched_enter(enum thread_class cls);
+
+/* FlutterCustomTaskRunners.thread_priority_setter */
+void thread_sched_priority_setter(FlutterThreadPriority priority);
+
+/* FlutterEnginePostCallbackOnAllNativeThreads callback, user data unused. */
+void thread_sched_native_thread_cb(FlutterNativeThreadType type, void *user_data);
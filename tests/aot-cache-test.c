@@ -0,0 +1,97 @@
+/*
+ * Test for the shared AOT data cache (src/aot-cache.c) on the stub engine.
+ *
+ * N sources acquiring the same ELF from their own threads must share one
+ * mapping, a second app gets its own, and once every source has released
+ * its data the stub holds no AOT data and libobs no cache entries.
+ *
+ *   aot-cache-test <path to the stub engine library>
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <obs-module.h>
+
+#include "aot-cache.h"
+#include "portable.h"
+#include "test-util.h"
+
+#define SOURCES 16
+#define ELF_SIZE (256 * 1024)
+
+static const char *const g_app = "aot-cache-test-app.so";
+static const char *const g_other = "aot-cache-test-other.so";
+
+static FlutterEngineAOTData g_data[SOURCES];
+
+static bool write_elf(const char *path, size_t size)
+{
+	FILE *f = fopen(path, "wb");
+	if (!f)
+		return false;
+	for (size_t i = 0; i < size; ++i)
+		fputc((int)(i & 0xff), f);
+	return fclose(f) == 0;
+}
+
+static void acquire(void *arg)
+{
+	const size_t i = (size_t)(uintptr_t)arg;
+	g_data[i] = aot_cache_acquire(g_app);
+}
+
+int main(int argc, char **argv)
+{
+	const stub_engine_get_stats_fn get_stats = test_load_stub(argc > 1 ? argv[1] : NULL);
+	if (!write_elf(g_app, ELF_SIZE) || !write_elf(g_other, ELF_SIZE / 2)) {
+		fprintf(stderr, "can't write the test ELF files\n");
+		return 1;
+	}
+
+	struct stub_engine_stats s;
+	const int allocs = bnum_allocs();
+
+	// Sources come up concurrently
+	pt_thread threads[SOURCES];
+	for (size_t i = 0; i < SOURCES; ++i)
+		CHECK(pt_thread_create(&threads[i], acquire, (void *)(uintptr_t)i));
+	for (size_t i = 0; i < SOURCES; ++i)
+		pt_thread_join(threads[i]);
+
+	get_stats(&s);
+	CHECK(s.aot_data == 1 && s.aot_bytes == ELF_SIZE);
+	for (size_t i = 0; i < SOURCES; ++i)
+		CHECK(g_data[i] && g_data[i] == g_data[0]);
+
+	const FlutterEngineAOTData other = aot_cache_acquire(g_other);
+	CHECK(other && other != g_data[0]);
+	CHECK(aot_cache_acquire("aot-cache-test-missing.so") == NULL);
+	get_stats(&s);
+	CHECK(s.aot_data == 2 && s.aot_bytes == ELF_SIZE + ELF_SIZE / 2);
+
+	// Releasing all but one source keeps the mapping
+	for (size_t i = SOURCES - 1; i > 0; --i)
+		aot_cache_release(g_data[i]);
+	get_stats(&s);
+	CHECK(s.aot_data == 2);
+
+	aot_cache_release(g_data[0]);
+	aot_cache_release(other);
+	get_stats(&s);
+	CHECK(s.aot_data == 0 && s.aot_bytes == 0);
+	CHECK(bnum_allocs() == allocs);
+
+	// And the next source maps it again
+	const FlutterEngineAOTData again = aot_cache_acquire(g_app);
+	get_stats(&s);
+	CHECK(again && s.aot_data == 1);
+	aot_cache_release(again);
+	get_stats(&s);
+	CHECK(s.aot_data == 0 && bnum_allocs() == allocs);
+
+	remove(g_app);
+	remove(g_other);
+	embedder_unload();
+	return test_finish("aot-cache-test");
+}
@@ -0,0 +1,48 @@
+/*
+ * Timing and reporting helpers shared by the benchmarks in this directory.
+ *
+ * Benchmarks print one line per case so runs can be diffed: the case name,
+ * then `key=value` pairs.  `--quick` cuts the iteration counts for the ctest
+ * smoke run; the numbers it prints are not meant to be compared.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+static inline uint64_t bench_now_ns(void)
+{
+#ifdef _WIN32
+	static LARGE_INTEGER freq;
+	LARGE_INTEGER now;
+	if (!freq.QuadPart)
+		QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&now);
+	return (uint64_t)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static inline bool bench_quick(int argc, char **argv)
+{
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--quick") == 0)
+			return true;
+	}
+	return false;
+}
+
+/* Keeps the optimiser from dropping a result nobody reads. */
+static volatile uint64_t bench_sink;
@@ -0,0 +1,199 @@
+/*
+ * cJSON vs StandardMessageCodec on obs_audio traffic.
+ *
+ * Decodes the same commands in both encodings the way on_audio_message()
+ * does – parse, then pull cmd/id/volume/loop/asset out of every item – and
+ * prints nanoseconds per message.  The messages are what the Dart side
+ * sends: a single play, and a batch of loads at scene start.
+ *
+ *   codec-bench [--quick]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench-util.h"
+#include "standard-codec.h"
+#include "third_party/cjson/cJSON.h"
+
+struct cmd {
+	char name[16];
+	int id;
+	float volume;
+	bool loop;
+	char asset[128];
+};
+
+//  ───────────────   decoders   ───────────────
+
+static bool json_item(const cJSON *item, struct cmd *out)
+{
+	const cJSON *v = cJSON_GetObjectItemCaseSensitive(item, "cmd");
+	if (!cJSON_IsString(v))
+		return false;
+	strncpy(out->name, v->valuestring, sizeof(out->name) - 1);
+	v = cJSON_GetObjectItemCaseSensitive(item, "id");
+	out->id = cJSON_IsNumber(v) ? v->valueint : 0;
+	v = cJSON_GetObjectItemCaseSensitive(item, "volume");
+	out->volume = cJSON_IsNumber(v) ? (float)v->valuedouble : 1.f;
+	out->loop = cJSON_IsTrue(cJSON_GetObjectItemCaseSensitive(item, "loop"));
+	v = cJSON_GetObjectItemCaseSensitive(item, "asset");
+	if (cJSON_IsString(v))
+		strncpy(out->asset, v->valuestring, sizeof(out->asset) - 1);
+	return true;
+}
+
+static int decode_json(const char *text, size_t len, struct cmd *out, int cap)
+{
+	cJSON *root = cJSON_ParseWithLength(text, len);
+	int n = 0;
+	if (cJSON_IsArray(root)) {
+		const cJSON *item;
+		cJSON_ArrayForEach(item, root)
+		{
+			if (n < cap && json_item(item, &out[n]))
+				++n;
+		}
+	} else if (root && json_item(root, &out[0])) {
+		n = 1;
+	}
+	cJSON_Delete(root);
+	return n;
+}
+
+static void smc_args(const struct smc_reader *r, const struct smc_value *map, struct cmd *out)
+{
+	struct smc_value v;
+	int64_t i;
+	double d;
+	out->id = smc_map_find(r, map, "id", &v) && smc_value_as_int(&v, &i) ? (int)i : 0;
+	out->volume = smc_map_find(r, map, "volume", &v) && smc_value_as_double(&v, &d) ? (float)d : 1.f;
+	out->loop = smc_map_find(r, map, "loop", &v) && v.type == SMC_TRUE;
+	if (smc_map_find(r, map, "asset", &v))
+		smc_value_copy_string(&v, out->asset, sizeof(out->asset));
+}
+
+static int decode_smc(const uint8_t *buf, size_t size, struct cmd *out, int cap)
+{
+	struct smc_reader r;
+	struct smc_value method, args;
+	smc_reader_init(&r, buf, size);
+	if (!smc_read_method_call(&r, &method, &args))
+		return 0;
+
+	if (!smc_value_is_string(&method, "batch")) {
+		smc_value_copy_string(&method, out[0].name, sizeof(out[0].name));
+		smc_args(&r, &args, &out[0]);
+		return 1;
+	}
+
+	int n = 0;
+	smc_enter(&r, &args);
+	for (uint32_t i = 0; i < args.children.count && n < cap; ++i) {
+		struct smc_value item, name;
+		const size_t pos = r.pos;
+		if (!smc_read_value(&r, &item))
+			return 0;
+		r.pos = pos;
+		if (!smc_skip_value(&r))
+			return 0;
+		if (!smc_map_find(&r, &item, "cmd", &name) || !smc_value_copy_string(&name, out[n].name, sizeof(out[n].name)))
+			continue;
+		smc_args(&r, &item, &out[n]);
+		++n;
+	}
+	return n;
+}
+
+//  ───────────────   messages   ───────────────
+
+#define BATCH 16
+
+static void write_cmd_map(struct smc_writer *w, const char *cmd, int id)
+{
+	char asset[64];
+	snprintf(asset, sizeof(asset), "sounds/effect_%02d.wav", id);
+	smc_write_map_header(w, cmd ? 5 : 4);
+	if (cmd) {
+		smc_write_string(w, "cmd");
+		smc_write_string(w, cmd);
+	}
+	smc_write_string(w, "id");
+	smc_write_int(w, id);
+	smc_write_string(w, "volume");
+	smc_write_double(w, 0.8);
+	smc_write_string(w, "loop");
+	smc_write_bool(w, false);
+	smc_write_string(w, "asset");
+	smc_write_string(w, asset);
+}
+
+static size_t json_cmd(char *out, size_t cap, const char *cmd, int id)
+{
+	return (size_t)snprintf(out, cap,
+				"{\"cmd\":\"%s\",\"id\":%d,\"volume\":0.8,\"loop\":false,"
+				"\"asset\":\"sounds/effect_%02d.wav\"}",
+				cmd, id, id);
+}
+
+static void run(const char *name, const char *json, size_t json_len, const uint8_t *smc, size_t smc_len,
+		int expect, int iterations)
+{
+	struct cmd out[BATCH];
+	uint64_t sum = 0;
+
+	uint64_t start = bench_now_ns();
+	for (int i = 0; i < iterations; ++i) {
+		memset(out, 0, sizeof(out));
+		sum += (uint64_t)decode_json(json, json_len, out, BATCH);
+	}
+	const double json_ns = (double)(bench_now_ns() - start) / iterations;
+
+	start = bench_now_ns();
+	for (int i = 0; i < iterations; ++i) {
+		memset(out, 0, sizeof(out));
+		sum += (uint64_t)decode_smc(smc, smc_len, out, BATCH);
+	}
+	const double smc_ns = (double)(bench_now_ns() - start) / iterations;
+
+	if (sum != (uint64_t)expect * 2 * iterations) {
+		fprintf(stderr, "%s: decoded %llu commands, expected %llu\n", name, (unsigned long long)sum,
+			(unsigned long long)expect * 2 * iterations);
+		exit(1);
+	}
+	bench_sink += sum;
+	printf("%-12s json_bytes=%zu smc_bytes=%zu json_ns=%.0f smc_ns=%.0f speedup=%.1fx\n", name, json_len,
+	       smc_len, json_ns, smc_ns, json_ns / smc_ns);
+}
+
+int main(int argc, char **argv)
+{
+	const int iterations = bench_quick(argc, argv) ? 2000 : 200000;
+	_Alignas(8) static uint8_t smc[8192];
+	static char json[8192];
+	struct smc_writer w;
+
+	// invokeMethod('play', {...})
+	size_t json_len = json_cmd(json, sizeof(json), "play", 7);
+	smc_writer_init(&w, smc, sizeof(smc));
+	smc_write_string(&w, "play");
+	write_cmd_map(&w, NULL, 7);
+	run("play", json, json_len, smc, w.pos, 1, iterations);
+
+	// invokeMethod('batch', [{'cmd': 'load', ...} x16])
+	json_len = 0;
+	json[json_len++] = '[';
+	smc_writer_init(&w, smc, sizeof(smc));
+	smc_write_string(&w, "batch");
+	smc_write_list_header(&w, BATCH);
+	for (int i = 0; i < BATCH; ++i) {
+		if (i)
+			json[json_len++] = ',';
+		json_len += json_cmd(json + json_len, sizeof(json) - json_len, "load", i);
+		write_cmd_map(&w, "load", i);
+	}
+	json[json_len++] = ']';
+	run("batch16", json, json_len, smc, w.pos, BATCH, iterations / 8);
+	return 0;
+}
@@ -0,0 +1,323 @@
+/*
+ * Fuzz test for the StandardMessageCodec reader (src/standard-codec.c).
+ *
+ * As a plain executable it runs deterministic rounds: a random message is
+ * written with the smc writer, read back and compared, then mutated (bit
+ * flips, clobbered sizes, truncation) and walked through every reader entry
+ * point.  Built with -DCODEC_FUZZ_LIBFUZZER and -fsanitize=fuzzer, the walk
+ * becomes a libFuzzer target instead.  Reads past the buffer are left to the
+ * sanitizers; the cursor and error invariants are checked here.
+ *
+ *   codec-fuzz [rounds] [seed]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "standard-codec.h"
+
+#define MAX_MESSAGE 4096
+#define MAX_DEPTH 6
+
+static int g_failures;
+
+#define CHECK(cond)                                                                   \
+	do {                                                                          \
+		if (!(cond)) {                                                        \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+			if (++g_failures > 20)                                        \
+				exit(1);                                              \
+		}                                                                     \
+	} while (0)
+
+//  ───────────────   walking arbitrary input   ───────────────
+
+static void probe_scalar(const struct smc_value *v)
+{
+	int64_t i;
+	double d;
+	char small[8];
+	smc_value_as_int(v, &i);
+	smc_value_as_double(v, &d);
+	if (smc_value_copy_string(v, small, sizeof(small)))
+		CHECK(strlen(small) < sizeof(small));
+}
+
+static void walk(struct smc_reader *r, int depth)
+{
+	struct smc_value v;
+	const size_t start = r->pos;
+	if (!smc_read_value(r, &v)) {
+		CHECK(r->error);
+		return;
+	}
+	CHECK(r->pos > start && r->pos <= r->size);
+	probe_scalar(&v);
+
+	if (v.type != SMC_LIST && v.type != SMC_MAP)
+		return;
+
+	if (v.type == SMC_MAP) {
+		static const char *const keys[] = {"cmd", "id", "volume", "asset", "port", ""};
+		struct smc_value found;
+		for (size_t k = 0; k < sizeof(keys) / sizeof(keys[0]); ++k) {
+			if (smc_map_find(r, &v, keys[k], &found))
+				probe_scalar(&found);
+		}
+	}
+
+	// Rewind and step over the whole container once, then walk its children
+	struct smc_reader skip = *r;
+	skip.pos = start;
+	const bool skipped = smc_skip_value(&skip);
+	CHECK(skip.pos <= skip.size);
+
+	if (depth >= MAX_DEPTH) {
+		*r = skip;
+		return;
+	}
+	const uint64_t children = (uint64_t)v.children.count * (v.type == SMC_MAP ? 2 : 1);
+	for (uint64_t i = 0; i < children && !r->error; ++i)
+		walk(r, depth + 1);
+	if (skipped && !r->error)
+		CHECK(r->pos == skip.pos);
+}
+
+static void fuzz_one(const uint8_t *data, size_t size)
+{
+	struct smc_reader r;
+	struct smc_value method, args;
+
+	smc_reader_init(&r, data, size);
+	while (r.pos < r.size && !r.error)
+		walk(&r, 0);
+	CHECK(r.pos <= r.size);
+
+	// A failed reader stays failed
+	if (r.error) {
+		struct smc_value v;
+		CHECK(!smc_read_value(&r, &v));
+	}
+
+	smc_reader_init(&r, data, size);
+	if (smc_read_method_call(&r, &method, &args)) {
+		CHECK(method.type == SMC_STRING);
+		if (args.type == SMC_LIST || args.type == SMC_MAP) {
+			smc_enter(&r, &args);
+			for (uint32_t i = 0; i < args.children.count && !r.error; ++i)
+				walk(&r, 1);
+		}
+	}
+}
+
+#ifdef CODEC_FUZZ_LIBFUZZER
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+	// Typed lists are aligned relative to the message start, as in the engine
+	static _Alignas(8) uint8_t copy[1 << 16];
+	if (size > sizeof(copy))
+		return 0;
+	memcpy(copy, data, size);
+	fuzz_one(copy, size);
+	return 0;
+}
+
+#else
+
+//  ───────────────   generated messages   ───────────────
+
+static uint64_t g_rng;
+
+static uint32_t rnd(uint32_t n)
+{
+	g_rng ^= g_rng << 13;
+	g_rng ^= g_rng >> 7;
+	g_rng ^= g_rng << 17;
+	return n ? (uint32_t)(g_rng % n) : 0;
+}
+
+/* Writes a random value with `w`, or, given the same rng state, reads it
+ * back with `r` and checks it matches. */
+static void value(struct smc_writer *w, struct smc_reader *r, int depth)
+{
+	static const char text[] = "obs_audio play batch cmd volume asset \xc3\xa9\xe2\x82\xac";
+	const uint32_t kind = rnd(depth < MAX_DEPTH - 1 ? 9 : 7);
+	struct smc_value v = {0};
+	if (r)
+		CHECK(smc_read_value(r, &v));
+
+	switch (kind) {
+	case 0:
+		if (w)
+			smc_write_null(w);
+		else
+			CHECK(v.type == SMC_NULL);
+		break;
+	case 1: {
+		const bool b = rnd(2);
+		if (w)
+			smc_write_bool(w, b);
+		else
+			CHECK(v.type == (b ? SMC_TRUE : SMC_FALSE));
+		break;
+	}
+	case 2: {
+		const int64_t i = rnd(2) ? (int64_t)rnd(1000) - 500 : ((int64_t)rnd(UINT32_MAX) << 20) - 1;
+		int64_t got;
+		if (w)
+			smc_write_int(w, i);
+		else
+			CHECK(smc_value_as_int(&v, &got) && got == i);
+		break;
+	}
+	case 3: {
+		const double d = (double)rnd(100000) / 7.0;
+		if (w)
+			smc_write_double(w, d);
+		else
+			CHECK(v.type == SMC_FLOAT64 && v.d == d);
+		break;
+	}
+	case 4: {
+		// Sizes around the one-byte/uint16 boundary exercise both encodings
+		const uint32_t len = rnd(4) ? rnd(sizeof(text)) : 250 + rnd(10);
+		char s[300];
+		for (uint32_t i = 0; i < len; ++i)
+			s[i] = text[i % (sizeof(text) - 1)];
+		if (w)
+			smc_write_string_n(w, s, len);
+		else
+			CHECK(v.type == SMC_STRING && v.data.count == len && memcmp(v.data.ptr, s, len) == 0);
+		break;
+	}
+	case 5: {
+		float f[16];
+		const uint32_t n = rnd(16);
+		for (uint32_t i = 0; i < n; ++i)
+			f[i] = (float)i * 0.5f;
+		if (w) {
+			smc_write_float32_list(w, f, n);
+		} else {
+			CHECK(v.type == SMC_FLOAT32_LIST && v.data.count == n);
+			CHECK(((uintptr_t)v.data.ptr & 3) == 0);
+			CHECK(n == 0 || memcmp(v.data.ptr, f, n * sizeof(float)) == 0);
+		}
+		break;
+	}
+	case 6: {
+		uint8_t b[32];
+		const uint32_t n = rnd(32);
+		for (uint32_t i = 0; i < n; ++i)
+			b[i] = (uint8_t)(i * 37);
+		if (w)
+			smc_write_uint8_list(w, b, n);
+		else
+			CHECK(v.type == SMC_UINT8_LIST && v.data.count == n && (n == 0 || memcmp(v.data.ptr, b, n) == 0));
+		break;
+	}
+	case 7: {
+		const uint32_t n = rnd(5);
+		if (w)
+			smc_write_list_header(w, n);
+		else
+			CHECK(v.type == SMC_LIST && v.children.count == n);
+		for (uint32_t i = 0; i < n; ++i)
+			value(w, r, depth + 1);
+		break;
+	}
+	default: {
+		const uint32_t n = rnd(4);
+		if (w)
+			smc_write_map_header(w, n);
+		else
+			CHECK(v.type == SMC_MAP && v.children.count == n);
+		for (uint32_t i = 0; i < n; ++i) {
+			value(w, r, depth + 1); // any key type is legal on the wire
+			value(w, r, depth + 1);
+		}
+		break;
+	}
+	}
+}
+
+static void mutate(uint8_t *buf, size_t *size)
+{
+	const uint32_t edits = 1 + rnd(4);
+	for (uint32_t e = 0; e < edits && *size; ++e) {
+		const size_t at = rnd((uint32_t)*size);
+		switch (rnd(5)) {
+		case 0:
+			buf[at] ^= (uint8_t)(1u << rnd(8));
+			break;
+		case 1:
+			buf[at] = (uint8_t)rnd(16); // a type byte
+			break;
+		case 2:
+			buf[at] = (uint8_t)(253 + rnd(3)); // a size escape
+			break;
+		case 3:
+			buf[at] = 0xff;
+			break;
+		default:
+			*size = at; // truncate
+			break;
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	const unsigned long rounds = argc > 1 ? strtoul(argv[1], NULL, 10) : 100000;
+	const unsigned long long seed = argc > 2 ? strtoull(argv[2], NULL, 10) : 0x5eed;
+	_Alignas(8) static uint8_t buf[MAX_MESSAGE];
+
+	for (unsigned long i = 0; i < rounds; ++i) {
+		const uint64_t state = (seed + i) * 0x9e3779b97f4a7c15ULL | 1;
+		struct smc_writer w;
+		struct smc_reader r;
+
+		// Round trip, sometimes wrapped as a method call
+		smc_writer_init(&w, buf, sizeof(buf));
+		g_rng = state;
+		const bool call = rnd(2);
+		if (call)
+			smc_write_string(&w, "batch");
+		value(&w, NULL, 0);
+		if (w.overflow)
+			continue;
+
+		smc_reader_init(&r, buf, w.pos);
+		g_rng = state;
+		CHECK(rnd(2) == call);
+		if (call) {
+			struct smc_value method, args;
+			CHECK(smc_read_method_call(&r, &method, &args) && smc_value_is_string(&method, "batch"));
+			r.pos = 0;
+			CHECK(smc_read_value(&r, &method));
+		}
+		value(NULL, &r, 0);
+		CHECK(!r.error && r.pos == w.pos);
+
+		// Then break it
+		size_t size = w.pos;
+		mutate(buf, &size);
+		fuzz_one(buf, size);
+
+		// And some noise
+		const size_t noise = rnd(64);
+		for (size_t b = 0; b < noise; ++b)
+			buf[b] = (uint8_t)rnd(256);
+		fuzz_one(buf, noise);
+	}
+
+	if (g_failures) {
+		fprintf(stderr, "codec-fuzz: %d failure(s)\n", g_failures);
+		return 1;
+	}
+	printf("codec-fuzz: %lu rounds ok\n", rounds);
+	return 0;
+}
+
+#endif
@@ -0,0 +1,108 @@
+/*
+ * Heap allocations per obs_audio message, without and with the JSON arena.
+ *
+ * "before" runs cJSON on counting malloc/free hooks, as the plug-in did
+ * before the arena; "after" installs the arena hooks and wraps each message
+ * in a json_arena_begin()/end() scope the way platform_message_cb() does.
+ * The oversized manifest shows the fallback once a parse outgrows the
+ * arena.
+ *
+ *   json-arena-bench [--quick]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench-util.h"
+#include "json-arena.h"
+#include "third_party/cjson/cJSON.h"
+
+static uint64_t g_mallocs;
+
+static void *CJSON_CDECL counting_malloc(size_t size)
+{
+	g_mallocs++;
+	return malloc(size);
+}
+
+/* What a handler does with the tree: look at every item's fields. */
+static uint64_t consume(const char *text, size_t len)
+{
+	cJSON *root = cJSON_ParseWithLength(text, len);
+	uint64_t n = 0;
+	if (cJSON_IsArray(root)) {
+		const cJSON *item;
+		cJSON_ArrayForEach(item, root)
+		{
+			n += (uint64_t)cJSON_GetArraySize(item);
+			n += cJSON_IsString(cJSON_GetObjectItemCaseSensitive(item, "asset"));
+		}
+	} else if (cJSON_IsObject(root)) {
+		n += (uint64_t)cJSON_GetArraySize(root);
+	}
+	cJSON_Delete(root);
+	return n;
+}
+
+static size_t build(char *out, size_t cap, int items)
+{
+	size_t len = 0;
+	if (items > 1)
+		out[len++] = '[';
+	for (int i = 0; i < items && len + 128 < cap; ++i) {
+		len += (size_t)snprintf(out + len, cap - len,
+					"%s{\"cmd\":\"load\",\"id\":%d,\"volume\":0.8,\"loop\":false,"
+					"\"asset\":\"sounds/effect_%03d.wav\"}",
+					i ? "," : "", i % 256, i);
+	}
+	if (items > 1)
+		out[len++] = ']';
+	out[len] = '\0';
+	return len;
+}
+
+static void run(const char *name, int items, int iterations)
+{
+	static char text[256 * 1024];
+	const size_t len = build(text, sizeof(text), items);
+
+	cJSON_Hooks counting = {.malloc_fn = counting_malloc, .free_fn = free};
+	cJSON_InitHooks(&counting);
+	g_mallocs = 0;
+	uint64_t start = bench_now_ns();
+	for (int i = 0; i < iterations; ++i)
+		bench_sink += consume(text, len);
+	const double before_ns = (double)(bench_now_ns() - start) / iterations;
+	const double before = (double)g_mallocs / iterations;
+
+	json_arena_install();
+	const struct json_arena_stats s0 = json_arena_thread_stats();
+	start = bench_now_ns();
+	for (int i = 0; i < iterations; ++i) {
+		json_arena_begin();
+		bench_sink += consume(text, len);
+		json_arena_end();
+	}
+	const double after_ns = (double)(bench_now_ns() - start) / iterations;
+	const struct json_arena_stats s1 = json_arena_thread_stats();
+	const double arena = (double)(s1.arena_allocs - s0.arena_allocs) / iterations;
+	const double heap = (double)(s1.heap_allocs - s0.heap_allocs) / iterations;
+
+	printf("%-10s bytes=%zu before_heap_allocs=%.1f after_heap_allocs=%.1f after_arena_allocs=%.1f "
+	       "before_ns=%.0f after_ns=%.0f\n",
+	       name, len, before, heap, arena, before_ns, after_ns);
+}
+
+int main(int argc, char **argv)
+{
+	const int iterations = bench_quick(argc, argv) ? 500 : 50000;
+
+	run("play", 1, iterations);
+	run("batch16", 16, iterations / 4);
+	run("batch255", 255, iterations / 32);
+	run("manifest", 2000, iterations / 256 + 1); // outgrows JSON_ARENA_SIZE
+
+	json_arena_thread_release();
+	return 0;
+}
@@ -0,0 +1,752 @@
+/*
+ * Just enough of libobs for the plug-in modules to run headless.
+ *
+ * Same signatures as libobs, so the modules compile unchanged against its
+ * headers; only the calls they make are here.  Logging goes to stderr at
+ * LOG_WARNING and above (OBS_MOCK_VERBOSE=1 for everything), and the bmem
+ * calls count live allocations like libobs does.  See obs-mock.h for what
+ * stands in for sources, video and graphics.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <obs-module.h>
+#include <graphics/graphics.h>
+#include <media-io/video-io.h>
+#include <util/platform.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include "bench-util.h"
+#include "obs-mock.h"
+#include "portable.h"
+
+static volatile long g_allocs;
+static volatile int64_t g_texture_bytes;
+static uint64_t g_frame_interval_ns = 1000000000ULL / 60;
+
+//  ───────────────   util/base.h   ───────────────
+
+void blog(int log_level, const char *format, ...)
+{
+	static int verbose = -1;
+	if (verbose < 0) {
+		const char *v = getenv("OBS_MOCK_VERBOSE");
+		verbose = v && v[0] == '1';
+	}
+	if (log_level > LOG_WARNING && !verbose)
+		return;
+
+	va_list args;
+	va_start(args, format);
+	vfprintf(stderr, format, args);
+	va_end(args);
+	fputc('\n', stderr);
+}
+
+//  ───────────────   util/bmem.h   ───────────────
+
+void *bmalloc(size_t size)
+{
+	void *ptr = malloc(size ? size : 1);
+	if (ptr)
+		pt_atomic_inc(&g_allocs);
+	return ptr;
+}
+
+void *brealloc(void *ptr, size_t size)
+{
+	if (!ptr)
+		return bmalloc(size);
+	return realloc(ptr, size ? size : 1);
+}
+
+void bfree(void *ptr)
+{
+	if (!ptr)
+		return;
+	pt_atomic_dec(&g_allocs);
+	free(ptr);
+}
+
+int bnum_allocs(void)
+{
+	return (int)g_allocs;
+}
+
+void *bmemdup(const void *ptr, size_t size)
+{
+	void *out = bmalloc(size);
+	if (out && size)
+		memcpy(out, ptr, size);
+	return out;
+}
+
+//  ───────────────   util/platform.h   ───────────────
+
+uint64_t os_gettime_ns(void)
+{
+	return bench_now_ns();
+}
+
+void os_sleep_ms(uint32_t duration)
+{
+#if defined(_WIN32)
+	Sleep(duration);
+#else
+	const struct timespec ts = {.tv_sec = duration / 1000, .tv_nsec = (long)(duration % 1000) * 1000000L};
+	nanosleep(&ts, NULL);
+#endif
+}
+
+int os_get_logical_cores(void)
+{
+#if defined(_WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (int)info.dwNumberOfProcessors;
+#else
+	return (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+}
+
+bool os_file_exists(const char *path)
+{
+	FILE *f = path ? fopen(path, "rb") : NULL;
+	if (f)
+		fclose(f);
+	return f != NULL;
+}
+
+char *os_quick_read_utf8_file(const char *path)
+{
+	FILE *f = path ? fopen(path, "rb") : NULL;
+	if (!f)
+		return NULL;
+	fseek(f, 0, SEEK_END);
+	const long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	char *text = size >= 0 ? bmalloc((size_t)size + 1) : NULL;
+	if (text) {
+		const size_t n = fread(text, 1, (size_t)size, f);
+		text[n] = '\0';
+	}
+	fclose(f);
+	return text;
+}
+
+/* Nothing asks for a directory: the mock has no module config path. */
+int os_mkdirs(const char *path)
+{
+	(void)path;
+	return MKDIR_ERROR;
+}
+
+void *os_dlopen(const char *path)
+{
+	if (!path)
+		return NULL;
+#if defined(_WIN32)
+	wchar_t wpath[MAX_PATH];
+	if (!MultiByteToWideChar(CP_UTF8, 0, path, -1, wpath, MAX_PATH))
+		return NULL;
+	return LoadLibraryW(wpath);
+#else
+	void *lib = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+	if (!lib)
+		blog(LOG_WARNING, "os_dlopen(%s): %s", path, dlerror());
+	return lib;
+#endif
+}
+
+void *os_dlsym(void *module, const char *func)
+{
+#if defined(_WIN32)
+	return (void *)GetProcAddress(module, func);
+#else
+	return dlsym(module, func);
+#endif
+}
+
+void os_dlclose(void *module)
+{
+	if (!module)
+		return;
+#if defined(_WIN32)
+	FreeLibrary(module);
+#else
+	dlclose(module);
+#endif
+}
+
+//  ───────────────   obs-data.h   ───────────────
+
+/* A flat list of named values; objects and arrays are never stored. */
+struct mock_value {
+	bool set;
+	long long i;
+	double d;
+	bool b;
+	char *s;
+};
+
+struct mock_item {
+	struct mock_item *next;
+	char *name;
+	struct mock_value user, def;
+};
+
+struct obs_data {
+	volatile long refs;
+	struct mock_item *items;
+};
+
+static struct mock_item *data_item(obs_data_t *data, const char *name, bool create)
+{
+	if (!data || !name)
+		return NULL;
+	for (struct mock_item *it = data->items; it; it = it->next) {
+		if (strcmp(it->name, name) == 0)
+			return it;
+	}
+	if (!create)
+		return NULL;
+
+	struct mock_item *it = calloc(1, sizeof(*it));
+	char *copy = it ? malloc(strlen(name) + 1) : NULL;
+	if (!copy) {
+		free(it);
+		return NULL;
+	}
+	strcpy(copy, name);
+	it->name = copy;
+	it->next = data->items;
+	data->items = it;
+	return it;
+}
+
+static const struct mock_value *data_value(obs_data_t *data, const char *name)
+{
+	const struct mock_item *it = data_item(data, name, false);
+	if (!it)
+		return NULL;
+	return it->user.set ? &it->user : it->def.set ? &it->def : NULL;
+}
+
+static void value_set_string(struct mock_value *v, const char *s)
+{
+	char *copy = malloc(strlen(s ? s : "") + 1);
+	if (!copy)
+		return;
+	strcpy(copy, s ? s : "");
+	free(v->s);
+	v->s = copy;
+	v->set = true;
+}
+
+obs_data_t *obs_data_create(void)
+{
+	obs_data_t *data = calloc(1, sizeof(*data));
+	if (data)
+		data->refs = 1;
+	return data;
+}
+
+/* There are no settings files; callers fall back to their defaults. */
+obs_data_t *obs_data_create_from_json_file_safe(const char *json_file, const char *backup_ext)
+{
+	(void)json_file;
+	(void)backup_ext;
+	return NULL;
+}
+
+void obs_data_release(obs_data_t *data)
+{
+	if (!data || pt_atomic_dec(&data->refs) > 0)
+		return;
+	while (data->items) {
+		struct mock_item *it = data->items;
+		data->items = it->next;
+		free(it->user.s);
+		free(it->def.s);
+		free(it->name);
+		free(it);
+	}
+	free(data);
+}
+
+obs_data_t *obs_data_get_obj(obs_data_t *data, const char *name)
+{
+	(void)data;
+	(void)name;
+	return NULL;
+}
+
+bool obs_data_has_user_value(obs_data_t *data, const char *name)
+{
+	const struct mock_item *it = data_item(data, name, false);
+	return it && it->user.set;
+}
+
+long long obs_data_get_int(obs_data_t *data, const char *name)
+{
+	const struct mock_value *v = data_value(data, name);
+	return v ? v->i : 0;
+}
+
+bool obs_data_get_bool(obs_data_t *data, const char *name)
+{
+	const struct mock_value *v = data_value(data, name);
+	return v ? v->b : false;
+}
+
+const char *obs_data_get_string(obs_data_t *data, const char *name)
+{
+	const struct mock_value *v = data_value(data, name);
+	return v && v->s ? v->s : "";
+}
+
+void obs_data_set_int(obs_data_t *data, const char *name, long long val)
+{
+	struct mock_item *it = data_item(data, name, true);
+	if (it)
+		it->user = (struct mock_value){.set = true, .i = val, .s = it->user.s};
+}
+
+void obs_data_set_bool(obs_data_t *data, const char *name, bool val)
+{
+	struct mock_item *it = data_item(data, name, true);
+	if (it)
+		it->user = (struct mock_value){.set = true, .b = val, .s = it->user.s};
+}
+
+void obs_data_set_string(obs_data_t *data, const char *name, const char *val)
+{
+	struct mock_item *it = data_item(data, name, true);
+	if (it)
+		value_set_string(&it->user, val);
+}
+
+void obs_data_set_default_int(obs_data_t *data, const char *name, long long val)
+{
+	struct mock_item *it = data_item(data, name, true);
+	if (it)
+		it->def = (struct mock_value){.set = true, .i = val, .s = it->def.s};
+}
+
+void obs_data_set_default_bool(obs_data_t *data, const char *name, bool val)
+{
+	struct mock_item *it = data_item(data, name, true);
+	if (it)
+		it->def = (struct mock_value){.set = true, .b = val, .s = it->def.s};
+}
+
+void obs_data_set_default_string(obs_data_t *data, const char *name, const char *val)
+{
+	struct mock_item *it = data_item(data, name, true);
+	if (it)
+		value_set_string(&it->def, val);
+}
+
+//  ───────────────   obs-properties.h   ───────────────
+
+/* Nothing headless shows a properties dialog. */
+obs_properties_t *obs_properties_create(void)
+{
+	return NULL;
+}
+
+obs_property_t *obs_properties_add_bool(obs_properties_t *props, const char *name, const char *description)
+{
+	(void)props;
+	(void)name;
+	(void)description;
+	return NULL;
+}
+
+obs_property_t *obs_properties_add_int(obs_properties_t *props, const char *name, const char *description, int min,
+				       int max, int step)
+{
+	(void)props;
+	(void)name;
+	(void)description;
+	(void)min;
+	(void)max;
+	(void)step;
+	return NULL;
+}
+
+obs_property_t *obs_properties_add_text(obs_properties_t *props, const char *name, const char *description,
+					enum obs_text_type type)
+{
+	(void)props;
+	(void)name;
+	(void)description;
+	(void)type;
+	return NULL;
+}
+
+obs_property_t *obs_properties_add_list(obs_properties_t *props, const char *name, const char *description,
+					enum obs_combo_type type, enum obs_combo_format format)
+{
+	(void)props;
+	(void)name;
+	(void)description;
+	(void)type;
+	(void)format;
+	return NULL;
+}
+
+size_t obs_property_list_add_int(obs_property_t *p, const char *name, long long val)
+{
+	(void)p;
+	(void)name;
+	(void)val;
+	return 0;
+}
+
+//  ───────────────   obs-module.h   ───────────────
+
+/* OBS_DECLARE_MODULE() defines this in the plug-in, which isn't linked here. */
+obs_module_t *obs_current_module(void)
+{
+	return NULL;
+}
+
+/* No data or config directories: effects and caches are unavailable. */
+char *obs_find_module_file(obs_module_t *module, const char *file)
+{
+	(void)module;
+	(void)file;
+	return NULL;
+}
+
+char *obs_module_get_config_path(obs_module_t *module, const char *file)
+{
+	(void)module;
+	(void)file;
+	return NULL;
+}
+
+//  ───────────────   obs.h: sources   ───────────────
+
+struct obs_source {
+	char name[64];
+};
+
+obs_source_t *obs_mock_source_create(const char *name)
+{
+	obs_source_t *source = calloc(1, sizeof(*source));
+	if (source)
+		snprintf(source->name, sizeof(source->name), "%s", name);
+	return source;
+}
+
+void obs_mock_source_destroy(obs_source_t *source)
+{
+	free(source);
+}
+
+const char *obs_source_get_name(const obs_source_t *source)
+{
+	return source ? source->name : NULL;
+}
+
+/* Only the mock's own sources exist, and they aren't listed by name. */
+obs_source_t *obs_get_source_by_name(const char *name)
+{
+	(void)name;
+	return NULL;
+}
+
+void obs_source_release(obs_source_t *source)
+{
+	(void)source;
+}
+
+obs_weak_source_t *obs_source_get_weak_source(obs_source_t *source)
+{
+	(void)source;
+	return NULL;
+}
+
+obs_source_t *obs_weak_source_get_source(obs_weak_source_t *weak)
+{
+	(void)weak;
+	return NULL;
+}
+
+void obs_weak_source_release(obs_weak_source_t *weak)
+{
+	(void)weak;
+}
+
+void obs_source_add_audio_capture_callback(obs_source_t *source, obs_source_audio_capture_t callback, void *param)
+{
+	(void)source;
+	(void)callback;
+	(void)param;
+}
+
+void obs_source_remove_audio_capture_callback(obs_source_t *source, obs_source_audio_capture_t callback, void *param)
+{
+	(void)source;
+	(void)callback;
+	(void)param;
+}
+
+void obs_source_output_audio(obs_source_t *source, const struct obs_source_audio *audio)
+{
+	(void)source;
+	(void)audio;
+}
+
+//  ───────────────   obs.h: audio and video   ───────────────
+
+void obs_mock_set_fps(uint32_t fps)
+{
+	g_frame_interval_ns = 1000000000ULL / (fps ? fps : 60);
+}
+
+bool obs_get_audio_info(struct obs_audio_info *oai)
+{
+	oai->samples_per_sec = 48000;
+	oai->speakers = SPEAKERS_STEREO;
+	return true;
+}
+
+uint64_t obs_get_frame_interval_ns(void)
+{
+	return g_frame_interval_ns;
+}
+
+/* OBS itself is never overloaded here. */
+uint64_t obs_get_average_frame_time_ns(void)
+{
+	return 0;
+}
+
+uint32_t obs_get_lagged_frames(void)
+{
+	return 0;
+}
+
+video_t *obs_get_video(void)
+{
+	return NULL;
+}
+
+uint32_t video_output_get_skipped_frames(const video_t *video)
+{
+	(void)video;
+	return 0;
+}
+
+//  ───────────────   graphics   ───────────────
+
+struct gs_texture {
+	uint32_t width, height;
+	enum gs_color_format format;
+	uint32_t linesize;
+	uint8_t *data;
+};
+
+struct gs_effect {
+	bool in_pass; // gs_effect_loop() state
+};
+
+struct gs_effect_param {
+	int unused;
+};
+
+static struct gs_effect g_base_effect;
+static struct gs_effect_param g_param;
+
+uint64_t obs_mock_texture_bytes(void)
+{
+	return (uint64_t)g_texture_bytes;
+}
+
+/* One thread does all the graphics work; see obs-mock.h. */
+void obs_enter_graphics(void) {}
+
+void obs_leave_graphics(void) {}
+
+uint32_t gs_get_format_bpp(enum gs_color_format format)
+{
+	switch (format) {
+	case GS_A8:
+	case GS_R8:
+		return 8;
+	default:
+		return 32;
+	}
+}
+
+gs_texture_t *gs_texture_create(uint32_t width, uint32_t height, enum gs_color_format color_format, uint32_t levels,
+				const uint8_t **data, uint32_t flags)
+{
+	(void)levels;
+	(void)flags;
+	gs_texture_t *tex = calloc(1, sizeof(*tex));
+	if (!tex)
+		return NULL;
+	tex->width = width;
+	tex->height = height;
+	tex->format = color_format;
+	tex->linesize = width * gs_get_format_bpp(color_format) / 8;
+	tex->data = malloc((size_t)tex->linesize * height);
+	if (!tex->data) {
+		free(tex);
+		return NULL;
+	}
+	if (data && data[0])
+		memcpy(tex->data, data[0], (size_t)tex->linesize * height);
+	pt_atomic_add64(&g_texture_bytes, (int64_t)tex->linesize * height);
+	return tex;
+}
+
+void gs_texture_destroy(gs_texture_t *tex)
+{
+	if (!tex)
+		return;
+	pt_atomic_add64(&g_texture_bytes, -(int64_t)tex->linesize * tex->height);
+	free(tex->data);
+	free(tex);
+}
+
+void gs_texture_set_image(gs_texture_t *tex, const uint8_t *data, uint32_t linesize, bool invert)
+{
+	const uint32_t row = linesize < tex->linesize ? linesize : tex->linesize;
+	for (uint32_t y = 0; y < tex->height; ++y) {
+		const uint32_t src_y = invert ? tex->height - 1 - y : y;
+		memcpy(tex->data + (size_t)y * tex->linesize, data + (size_t)src_y * linesize, row);
+	}
+}
+
+bool gs_texture_map(gs_texture_t *tex, uint8_t **ptr, uint32_t *linesize)
+{
+	*ptr = tex->data;
+	*linesize = tex->linesize;
+	return true;
+}
+
+void gs_texture_unmap(gs_texture_t *tex)
+{
+	(void)tex;
+}
+
+uint32_t gs_texture_get_width(const gs_texture_t *tex)
+{
+	return tex->width;
+}
+
+uint32_t gs_texture_get_height(const gs_texture_t *tex)
+{
+	return tex->height;
+}
+
+enum gs_color_format gs_texture_get_color_format(const gs_texture_t *tex)
+{
+	return tex->format;
+}
+
+gs_effect_t *obs_get_base_effect(enum obs_base_effect effect)
+{
+	(void)effect;
+	return &g_base_effect;
+}
+
+gs_effect_t *gs_effect_create_from_file(const char *file, char **error_string)
+{
+	(void)file;
+	if (error_string)
+		*error_string = NULL;
+	return NULL;
+}
+
+void gs_effect_destroy(gs_effect_t *effect)
+{
+	(void)effect;
+}
+
+gs_eparam_t *gs_effect_get_param_by_name(const gs_effect_t *effect, const char *name)
+{
+	(void)effect;
+	(void)name;
+	return &g_param;
+}
+
+/* One pass per technique: true on the way in, false once it has run. */
+bool gs_effect_loop(gs_effect_t *effect, const char *name)
+{
+	(void)name;
+	if (!effect)
+		return false;
+	effect->in_pass = !effect->in_pass;
+	return effect->in_pass;
+}
+
+void gs_effect_set_texture(gs_eparam_t *param, gs_texture_t *val)
+{
+	(void)param;
+	(void)val;
+}
+
+void gs_effect_set_texture_srgb(gs_eparam_t *param, gs_texture_t *val)
+{
+	(void)param;
+	(void)val;
+}
+
+void gs_effect_set_vec2(gs_eparam_t *param, const struct vec2 *val)
+{
+	(void)param;
+	(void)val;
+}
+
+void gs_effect_set_float(gs_eparam_t *param, float val)
+{
+	(void)param;
+	(void)val;
+}
+
+void gs_draw_sprite(gs_texture_t *tex, uint32_t flip, uint32_t width, uint32_t height)
+{
+	(void)tex;
+	(void)flip;
+	(void)width;
+	(void)height;
+}
+
+static bool g_srgb;
+
+bool gs_framebuffer_srgb_enabled(void)
+{
+	return g_srgb;
+}
+
+void gs_enable_framebuffer_srgb(bool enable)
+{
+	g_srgb = enable;
+}
+
+void gs_blend_state_push(void) {}
+
+void gs_blend_state_pop(void) {}
+
+void gs_blend_function(enum gs_blend_type src, enum gs_blend_type dest)
+{
+	(void)src;
+	(void)dest;
+}
@@ -0,0 +1,24 @@
+/*
+ * Test-side controls of the libobs mock (obs-mock.c).
+ *
+ * The mock has no scenes or outputs: sources are bare named objects created
+ * here, the canvas runs at a fixed frame rate, and textures are plain
+ * memory, so "uploads" cost what the copies into them cost.  The graphics
+ * context is not locked; tests run video_tick, video_render and source
+ * destruction on one thread, as OBS's graphics thread would.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <obs-module.h>
+
+obs_source_t *obs_mock_source_create(const char *name);
+void obs_mock_source_destroy(obs_source_t *source);
+
+/* obs_get_frame_interval_ns(); 60 until set. */
+void obs_mock_set_fps(uint32_t fps);
+
+/* Bytes of texture memory currently allocated. */
+uint64_t obs_mock_texture_bytes(void);
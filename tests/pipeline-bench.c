@@ -0,0 +1,214 @@
+/*
+ * End-to-end frame pipeline on the stub engine, without OBS.
+ *
+ * Creates 1, 4, 8 and 16 sources (one engine each) at 720p, 1080p and 4K
+ * and plays OBS's graphics thread at 60 fps: video_tick and video_render for
+ * every source, each frame.  The stub engine presents at the same rate, so
+ * every frame goes through the real raster-thread copy, upload ring and
+ * vsync path.  The numbers come from obs_flutter_get_stats(), as Dart would
+ * read them, summed or worst-of over the sources:
+ *
+ *   presented/uploaded  frames per source per second
+ *   upload_p50/p99      engine present -> texture ready to draw (worst source)
+ *   present_us          raster-thread copy per presented frame
+ *   graphics_us         video_tick + video_render for all sources, per OBS frame
+ *   first_frame_ms      source creation -> first frame (worst source)
+ *
+ * Textures are plain memory here, so the upload cost is the copy into them;
+ * a GPU driver adds its own on top.  --quick runs 1 and 4 sources briefly.
+ *
+ *   pipeline-bench [--quick]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <obs-module.h>
+#include <util/platform.h>
+
+#include "bench-util.h"
+#include "engine-procs.h"
+#include "json-arena.h"
+#include "obs-flutter-api.h"
+#include "obs-mock.h"
+#include "stub-engine.h"
+#include "texture-pool.h"
+
+extern struct obs_source_info flutter_source_info;
+void flutter_source_free_graphics(void);
+
+#define FPS 60
+#define MAX_SOURCES 16
+
+struct run_stats {
+	uint64_t presented, uploaded, render_ns, present_ns;
+	uint64_t upload_p50, upload_p99, first_frame;
+	int reporting; // sources with a handle
+};
+
+static struct {
+	stub_engine_get_stats_fn get_stats;
+	stub_engine_ffi_handles_fn ffi_handles;
+} g_stub;
+
+static bool load_stub(void)
+{
+	void *lib = os_dlopen(FLUTTER_ENGINE_LIBRARY);
+	g_stub.get_stats = lib ? (stub_engine_get_stats_fn)os_dlsym(lib, "stub_engine_get_stats") : NULL;
+	g_stub.ffi_handles = lib ? (stub_engine_ffi_handles_fn)os_dlsym(lib, "stub_engine_ffi_handles") : NULL;
+	return g_stub.get_stats && g_stub.ffi_handles;
+}
+
+static void sleep_until(uint64_t deadline_ns)
+{
+	for (;;) {
+		const uint64_t now = bench_now_ns();
+		if (now >= deadline_ns)
+			return;
+		const uint64_t left_ms = (deadline_ns - now) / 1000000;
+		if (left_ms > 1)
+			os_sleep_ms((uint32_t)left_ms - 1);
+	}
+}
+
+/* One OBS frame on the graphics thread; returns the time it took. */
+static uint64_t graphics_frame(void **sources, int n)
+{
+	const uint64_t start = bench_now_ns();
+	for (int i = 0; i < n; ++i)
+		flutter_source_info.video_tick(sources[i], 1.f / FPS);
+	for (int i = 0; i < n; ++i)
+		flutter_source_info.video_render(sources[i], NULL);
+	return bench_now_ns() - start;
+}
+
+static void collect(struct run_stats *out)
+{
+	int64_t handles[MAX_SOURCES];
+	const size_t n = g_stub.ffi_handles(handles, MAX_SOURCES);
+	memset(out, 0, sizeof(*out));
+	for (size_t i = 0; i < n; ++i) {
+		obs_flutter_stats st = {.struct_size = sizeof(st)};
+		if (obs_flutter_get_stats(handles[i], &st) != OBS_FLUTTER_OK)
+			continue;
+		out->reporting++;
+		out->presented += st.frames_presented;
+		out->uploaded += st.frames_uploaded;
+		out->render_ns += st.render_ns_total;
+		out->present_ns += st.present_ns_total;
+		if (st.upload_latency_p50_ns > out->upload_p50)
+			out->upload_p50 = st.upload_latency_p50_ns;
+		if (st.upload_latency_p99_ns > out->upload_p99)
+			out->upload_p99 = st.upload_latency_p99_ns;
+		if (st.first_frame_ns > out->first_frame)
+			out->first_frame = st.first_frame_ns;
+	}
+}
+
+static bool run(const char *name, uint32_t width, uint32_t height, int n, double seconds)
+{
+	obs_data_t *settings = obs_data_create();
+	flutter_source_info.get_defaults(settings);
+	obs_data_set_int(settings, "width", width);
+	obs_data_set_int(settings, "height", height);
+
+	obs_source_t *obs_sources[MAX_SOURCES];
+	void *sources[MAX_SOURCES];
+	for (int i = 0; i < n; ++i) {
+		char source_name[32];
+		snprintf(source_name, sizeof(source_name), "bench %d", i);
+		obs_sources[i] = obs_mock_source_create(source_name);
+		sources[i] = flutter_source_info.create(settings, obs_sources[i]);
+		flutter_source_info.show(sources[i]);
+		flutter_source_info.activate(sources[i]);
+	}
+
+	// Until every engine has answered its handle request and shown a frame
+	const uint64_t interval = 1000000000ULL / FPS;
+	uint64_t next = bench_now_ns();
+	const uint64_t give_up = next + 10000000000ULL;
+	struct run_stats warm;
+	do {
+		graphics_frame(sources, n);
+		next += interval;
+		sleep_until(next);
+		collect(&warm);
+	} while ((warm.reporting < n || warm.uploaded < (uint64_t)warm.reporting) && bench_now_ns() < give_up);
+
+	const uint64_t frames = (uint64_t)(seconds * FPS);
+	uint64_t graphics_ns = 0, graphics_max = 0;
+	next = bench_now_ns();
+	const uint64_t start = next;
+	for (uint64_t f = 0; f < frames; ++f) {
+		const uint64_t ns = graphics_frame(sources, n);
+		graphics_ns += ns;
+		if (ns > graphics_max)
+			graphics_max = ns;
+		next += interval;
+		sleep_until(next);
+	}
+	const double elapsed = (double)(bench_now_ns() - start) / 1e9;
+
+	struct run_stats end;
+	collect(&end);
+
+	for (int i = 0; i < n; ++i) {
+		flutter_source_info.destroy(sources[i]);
+		obs_mock_source_destroy(obs_sources[i]);
+	}
+	obs_data_release(settings);
+
+	const bool ok = end.reporting == n && end.uploaded > warm.uploaded;
+	const double per_source = (double)n * elapsed;
+	const uint64_t presented = end.presented - warm.presented;
+	printf("%-6s sources=%-2d presented_fps=%.1f uploaded_fps=%.1f upload_p50_ms=%.2f upload_p99_ms=%.2f "
+	       "present_us=%.0f graphics_us=%.0f graphics_max_us=%.0f first_frame_ms=%.1f%s\n",
+	       name, n, (double)presented / per_source, (double)(end.uploaded - warm.uploaded) / per_source,
+	       (double)end.upload_p50 / 1e6, (double)end.upload_p99 / 1e6,
+	       presented ? (double)(end.present_ns - warm.present_ns) / (double)presented / 1e3 : 0.0,
+	       frames ? (double)graphics_ns / (double)frames / 1e3 : 0.0, (double)graphics_max / 1e3,
+	       (double)end.first_frame / 1e6, ok ? "" : "  FAILED");
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	static const struct {
+		const char *name;
+		uint32_t width, height;
+	} sizes[] = {{"720p", 1280, 720}, {"1080p", 1920, 1080}, {"4K", 3840, 2160}};
+	static const int counts[] = {1, 4, 8, 16};
+
+	const bool quick = bench_quick(argc, argv);
+	const double seconds = quick ? 0.25 : 5.0;
+	const size_t count_cases = quick ? 2 : sizeof(counts) / sizeof(counts[0]);
+
+	if (!load_stub()) {
+		fprintf(stderr, "can't load the stub engine from %s\n", FLUTTER_ENGINE_LIBRARY);
+		return 1;
+	}
+	json_arena_install();
+	obs_mock_set_fps(FPS);
+
+	bool ok = true;
+	for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+		for (size_t c = 0; c < count_cases; ++c)
+			ok &= run(sizes[s].name, sizes[s].width, sizes[s].height, counts[c], seconds);
+	}
+
+	// As obs_module_unload()
+	obs_enter_graphics();
+	texture_pool_free_all();
+	flutter_source_free_graphics();
+	obs_leave_graphics();
+	embedder_unload();
+
+	struct stub_engine_stats st;
+	g_stub.get_stats(&st);
+	if (st.engines || st.aot_data) {
+		fprintf(stderr, "pipeline-bench: %ld engine(s) still running\n", st.engines);
+		ok = false;
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+/*
+ * Smoke test for the stub engine, loaded the way the plug-in loads an engine.
+ *
+ * Runs one engine on the software renderer with a custom platform runner
+ * and a vsync callback, the main thread standing in for the plug-in's
+ * worker: it runs posted tasks and hands batons back.  Then checks frames,
+ * tasks and batons flowed and that shutdown leaves nothing behind.
+ *
+ *   stub-engine-test <path to the stub engine library>
+ */
+
+#include <string.h>
+
+#include "bench-util.h"
+#include "portable.h"
+#include "test-util.h"
+
+#define RING 256
+
+static struct {
+	pt_mutex lock;
+	FlutterTask tasks[RING];
+	uint32_t head, tail;
+	volatile int64_t baton;
+	volatile long presented;
+} g;
+
+static void post_task(FlutterTask task, uint64_t target_time, void *user_data)
+{
+	(void)target_time;
+	(void)user_data;
+	pt_mutex_lock(&g.lock);
+	if (g.tail - g.head < RING)
+		g.tasks[g.tail++ % RING] = task;
+	pt_mutex_unlock(&g.lock);
+}
+
+static bool runs_on_current_thread(void *user_data)
+{
+	(void)user_data;
+	return false;
+}
+
+static void vsync(void *user_data, intptr_t baton)
+{
+	(void)user_data;
+	pt_atomic_xchg64(&g.baton, (int64_t)baton);
+}
+
+static bool present(void *user_data, const void *allocation, size_t row_bytes, size_t height)
+{
+	(void)user_data;
+	CHECK(allocation && row_bytes == 64 * 4 && height == 32);
+	pt_atomic_inc(&g.presented);
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	const stub_engine_get_stats_fn get_stats = test_load_stub(argc > 1 ? argv[1] : NULL);
+	pt_mutex_init(&g.lock);
+
+	const FlutterRendererConfig renderer = {
+		.type = kSoftware,
+		.software = {.struct_size = sizeof(FlutterSoftwareRendererConfig), .surface_present_callback = present},
+	};
+	const FlutterTaskRunnerDescription platform = {
+		.struct_size = sizeof(platform),
+		.runs_task_on_current_thread_callback = runs_on_current_thread,
+		.post_task_callback = post_task,
+		.identifier = 1,
+	};
+	const FlutterCustomTaskRunners runners = {.struct_size = sizeof(runners), .platform_task_runner = &platform};
+	const FlutterProjectArgs args = {
+		.struct_size = sizeof(args),
+		.assets_path = "",
+		.icu_data_path = "",
+		.custom_task_runners = &runners,
+		.vsync_callback = vsync,
+	};
+
+	FLUTTER_API_SYMBOL(FlutterEngine) engine = NULL;
+	CHECK(g_embedder.Initialize(FLUTTER_ENGINE_VERSION, &renderer, &args, NULL, &engine) == kSuccess);
+	CHECK(g_embedder.RunInitialized(engine) == kSuccess);
+	const FlutterWindowMetricsEvent metrics = {.struct_size = sizeof(metrics), .width = 64, .height = 32, .pixel_ratio = 1.0};
+	CHECK(g_embedder.SendWindowMetricsEvent(engine, &metrics) == kSuccess);
+
+	const uint64_t end = bench_now_ns() + 300000000ULL;
+	while (bench_now_ns() < end) {
+		const int64_t baton = pt_atomic_xchg64(&g.baton, 0);
+		if (baton) {
+			const uint64_t now = (g_embedder.GetCurrentTime)();
+			CHECK(g_embedder.OnVsync(engine, (intptr_t)baton, now, now + 16666667ULL) == kSuccess);
+		}
+
+		FlutterTask tasks[RING];
+		uint32_t n = 0;
+		pt_mutex_lock(&g.lock);
+		while (g.head != g.tail)
+			tasks[n++] = g.tasks[g.head++ % RING];
+		pt_mutex_unlock(&g.lock);
+		for (uint32_t i = 0; i < n; ++i)
+			CHECK(g_embedder.RunTask(engine, &tasks[i]) == kSuccess);
+
+		os_sleep_ms(1);
+	}
+
+	CHECK(g_embedder.Shutdown(engine) == kSuccess);
+
+	struct stub_engine_stats s;
+	get_stats(&s);
+	printf("frames=%llu tasks_posted=%llu tasks_run=%llu vsync_requests=%llu vsync_returned=%llu\n",
+	       (unsigned long long)s.frames, (unsigned long long)s.tasks_posted, (unsigned long long)s.tasks_run,
+	       (unsigned long long)s.vsync_requests, (unsigned long long)s.vsync_returned);
+	CHECK(s.engines == 0);
+	CHECK(s.frames > 0 && s.frames == (uint64_t)g.presented);
+	CHECK(s.tasks_run > 0 && s.tasks_run <= s.tasks_posted);
+	CHECK(s.vsync_returned > 0 && s.vsync_returned <= s.vsync_requests);
+	// Every frame after the first waited for a baton
+	CHECK(s.frames <= s.vsync_returned + 1);
+
+	pt_mutex_destroy(&g.lock);
+	embedder_unload();
+	return test_finish("stub-engine-test");
+}
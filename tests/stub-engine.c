@@ -0,0 +1,596 @@
+/*
+ * Stub Flutter engine; see stub-engine.h.
+ *
+ * Each engine owns two timers from portable.h: the frame timer stands in for
+ * the UI and raster threads, and the task timer posts to the embedder's
+ * platform runner.  View metrics are shared with the embedder's threads under
+ * `lock`; backing stores and the software surface belong to the frame timer.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#define FLUTTER_EXPORT __declspec(dllexport)
+#else
+#define FLUTTER_EXPORT __attribute__((visibility("default")))
+#endif
+
+#include "flutter_embedder.h"
+#include "portable.h"
+#include "bench-util.h"
+#include "stub-engine.h"
+
+#define STUB_MAX_VIEWS 32
+#define STUB_MAX_ENGINES 64
+
+static struct {
+	volatile long engines, aot_data;
+	volatile int64_t aot_bytes, frames, tasks_posted, tasks_run, vsync_requests, vsync_returned;
+	volatile int64_t platform_messages, paused, resumed;
+} g_stats;
+
+/* Running engines, for stub_engine_ffi_handles() */
+static struct _FlutterEngine *g_engines[STUB_MAX_ENGINES];
+static pt_rwlock g_engines_lock = PT_RWLOCK_INIT;
+
+struct stub_view {
+	bool exists;
+	uint32_t width, height;
+};
+
+struct stub_store {
+	FlutterBackingStore store;
+	uint32_t width, height;
+	bool valid;
+};
+
+struct _FlutterEngine {
+	FlutterSoftwareRendererConfig software;
+	FlutterCompositor compositor;
+	bool has_compositor;
+	FlutterTaskRunnerDescription platform;
+	bool has_platform;
+	void (*priority_setter)(FlutterThreadPriority);
+	VsyncCallback vsync_cb;
+	FlutterPlatformMessageCallback message_cb;
+	void *user_data;
+
+	pt_mutex lock;
+	struct stub_view views[STUB_MAX_VIEWS];
+	FlutterNativeThreadCallback native_cb; // run once on the frame timer
+	void *native_data;
+	volatile long paused; // from flutter/lifecycle
+
+	pt_timer *frame_timer, *task_timer;
+	struct stub_store stores[STUB_MAX_VIEWS]; // compositor
+	uint8_t *surface;                         // software renderer, view 0
+	size_t surface_cap;
+	uint64_t frame;
+	bool thread_set_up;
+
+	volatile int64_t baton;       // outstanding, 0 when none
+	volatile int64_t vsync_start; // set when the baton comes back
+	int64_t last_baton;
+	volatile int64_t next_task;
+
+	bool handle_requested;        // platform thread
+	volatile int64_t ffi_handle;  // from the "obs_ffi" reply, 0 until then
+};
+
+struct _FlutterPlatformMessageResponseHandle {
+	struct _FlutterEngine *engine;
+};
+
+struct _FlutterEngineAOTData {
+	size_t size;
+	uint8_t bytes[]; // the ELF, read in place of a mapping
+};
+
+static uint32_t env_u32(const char *name, uint32_t fallback)
+{
+	const char *v = getenv(name);
+	return v && *v ? (uint32_t)strtoul(v, NULL, 10) : fallback;
+}
+
+static void sleep_ms(uint32_t ms)
+{
+#ifdef _WIN32
+	Sleep(ms);
+#else
+	const struct timespec ts = {.tv_sec = ms / 1000, .tv_nsec = (long)(ms % 1000) * 1000000L};
+	nanosleep(&ts, NULL);
+#endif
+}
+
+static uint64_t stub_current_time(void)
+{
+	return bench_now_ns();
+}
+
+//  ───────────────   frames (frame timer)   ───────────────
+
+/* A gradient that moves every frame, so each one really is written. */
+static void fill(uint8_t *pixels, size_t row_bytes, size_t width_bytes, size_t height, uint64_t frame)
+{
+	for (size_t y = 0; y < height; ++y)
+		memset(pixels + y * row_bytes, (int)((y + frame) & 0xff), width_bytes);
+}
+
+static void collect_store(struct _FlutterEngine *e, struct stub_store *s)
+{
+	if (!s->valid)
+		return;
+	e->compositor.collect_backing_store_callback(&s->store, e->compositor.user_data);
+	s->valid = false;
+}
+
+static void present_compositor(struct _FlutterEngine *e, FlutterViewId id, uint32_t width, uint32_t height)
+{
+	struct stub_store *s = &e->stores[id];
+	if (s->valid && (s->width != width || s->height != height))
+		collect_store(e, s);
+
+	if (!s->valid) {
+		const FlutterBackingStoreConfig config = {
+			.struct_size = sizeof(config),
+			.size = {width, height},
+			.view_id = id,
+		};
+		memset(&s->store, 0, sizeof(s->store));
+		s->store.struct_size = sizeof(s->store);
+		if (!e->compositor.create_backing_store_callback(&config, &s->store, e->compositor.user_data))
+			return;
+		s->valid = true;
+		s->width = width;
+		s->height = height;
+	}
+
+	const FlutterSoftwareBackingStore2 *sw = &s->store.software2;
+	const size_t bpp = sw->pixel_format == kFlutterSoftwarePixelFormatGray8 ? 1 : 4;
+	// The engine renders into the store even though the field is const
+	fill((uint8_t *)sw->allocation, sw->row_bytes, (size_t)width * bpp, sw->height, e->frame);
+
+	const FlutterLayer layer = {
+		.struct_size = sizeof(layer),
+		.type = kFlutterLayerContentTypeBackingStore,
+		.backing_store = &s->store,
+		.size = {width, height},
+	};
+	const FlutterLayer *layers[] = {&layer};
+	const FlutterPresentViewInfo info = {
+		.struct_size = sizeof(info),
+		.view_id = id,
+		.layers = layers,
+		.layers_count = 1,
+		.user_data = e->compositor.user_data,
+	};
+	if (e->compositor.present_view_callback(&info))
+		pt_atomic_inc64(&g_stats.frames);
+}
+
+static void present_surface(struct _FlutterEngine *e, uint32_t width, uint32_t height)
+{
+	const size_t row_bytes = (size_t)width * 4;
+	const size_t size = row_bytes * height;
+	if (size > e->surface_cap) {
+		uint8_t *buf = realloc(e->surface, size);
+		if (!buf)
+			return;
+		e->surface = buf;
+		e->surface_cap = size;
+	}
+	fill(e->surface, row_bytes, row_bytes, height, e->frame);
+	if (e->software.surface_present_callback(e->user_data, e->surface, row_bytes, height))
+		pt_atomic_inc64(&g_stats.frames);
+}
+
+static void render(struct _FlutterEngine *e)
+{
+	struct stub_view views[STUB_MAX_VIEWS];
+	pt_mutex_lock(&e->lock);
+	memcpy(views, e->views, sizeof(views));
+	pt_mutex_unlock(&e->lock);
+
+	e->frame++;
+	for (FlutterViewId id = 0; id < STUB_MAX_VIEWS; ++id) {
+		if (e->has_compositor && !views[id].exists)
+			collect_store(e, &e->stores[id]);
+		if (!views[id].exists || !views[id].width || !views[id].height)
+			continue;
+		if (e->has_compositor)
+			present_compositor(e, id, views[id].width, views[id].height);
+		else if (id == 0)
+			present_surface(e, views[id].width, views[id].height);
+	}
+}
+
+static void frame_tick(void *param)
+{
+	struct _FlutterEngine *e = param;
+
+	if (!e->thread_set_up) {
+		e->thread_set_up = true;
+		if (e->priority_setter)
+			e->priority_setter(kRaster);
+	}
+	pt_mutex_lock(&e->lock);
+	const FlutterNativeThreadCallback native_cb = e->native_cb;
+	void *native_data = e->native_data;
+	e->native_cb = NULL;
+	pt_mutex_unlock(&e->lock);
+	if (native_cb) {
+		native_cb(kFlutterNativeThreadTypeUI, native_data);
+		native_cb(kFlutterNativeThreadTypeRender, native_data);
+	}
+
+	if (e->paused)
+		return;
+
+	// Without a vsync callback every tick is a frame; with one, a frame
+	// waits for its baton and then for the start time that came with it.
+	bool draw = !e->vsync_cb;
+	if (e->vsync_cb) {
+		const int64_t start = e->vsync_start;
+		if (start && stub_current_time() >= (uint64_t)start) {
+			pt_atomic_xchg64(&e->vsync_start, 0);
+			draw = true;
+		}
+	}
+	if (draw)
+		render(e);
+
+	if (e->vsync_cb && !e->baton && !e->vsync_start) {
+		pt_atomic_xchg64(&e->baton, ++e->last_baton);
+		pt_atomic_inc64(&g_stats.vsync_requests);
+		e->vsync_cb(e->user_data, (intptr_t)e->last_baton);
+	}
+}
+
+static void task_tick(void *param)
+{
+	struct _FlutterEngine *e = param;
+	const FlutterTask task = {
+		.runner = (FlutterTaskRunner)e,
+		.task = (uint64_t)pt_atomic_inc64(&e->next_task),
+	};
+	pt_atomic_inc64(&g_stats.tasks_posted);
+	e->platform.post_task_callback(task, stub_current_time(), e->platform.user_data);
+}
+
+//  ───────────────   proc table   ───────────────
+
+static FlutterEngineResult stub_initialize(size_t version, const FlutterRendererConfig *config,
+					   const FlutterProjectArgs *args, void *user_data,
+					   FLUTTER_API_SYMBOL(FlutterEngine) * engine_out)
+{
+	if (version != FLUTTER_ENGINE_VERSION || !config || !args || !engine_out)
+		return kInvalidArguments;
+	if (config->type != kSoftware) // the stub only renders in software
+		return kInvalidArguments;
+
+	const uint32_t init_ms = env_u32("STUB_ENGINE_INIT_MS", 0);
+	if (init_ms)
+		sleep_ms(init_ms);
+
+	struct _FlutterEngine *e = calloc(1, sizeof(*e));
+	if (!e)
+		return kInternalInconsistency;
+
+	e->software = config->software;
+	if (args->compositor) {
+		e->compositor = *args->compositor;
+		e->has_compositor = true;
+	}
+	if (args->custom_task_runners) {
+		const FlutterCustomTaskRunners *runners = args->custom_task_runners;
+		if (runners->platform_task_runner) {
+			e->platform = *runners->platform_task_runner;
+			e->has_platform = true;
+		}
+		e->priority_setter = runners->thread_priority_setter;
+	}
+	e->vsync_cb = args->vsync_callback;
+	e->message_cb = args->platform_message_callback;
+	e->user_data = user_data;
+	pt_mutex_init(&e->lock);
+	e->views[0].exists = true; // the implicit view
+
+	pt_rwlock_write_lock(&g_engines_lock);
+	for (int i = 0; i < STUB_MAX_ENGINES; ++i) {
+		if (!g_engines[i]) {
+			g_engines[i] = e;
+			break;
+		}
+	}
+	pt_rwlock_write_unlock(&g_engines_lock);
+
+	if (args->log_message_callback)
+		args->log_message_callback("stub", "stub engine initialized", user_data);
+	pt_atomic_inc(&g_stats.engines);
+	*engine_out = e;
+	return kSuccess;
+}
+
+static FlutterEngineResult stub_run_initialized(FLUTTER_API_SYMBOL(FlutterEngine) e)
+{
+	if (!e || e->frame_timer)
+		return kInvalidArguments;
+
+	const uint32_t fps = env_u32("STUB_ENGINE_FPS", 60);
+	const uint32_t task_hz = env_u32("STUB_ENGINE_TASK_HZ", 120);
+	e->frame_timer = pt_timer_start(0, fps ? (1000 + fps / 2) / fps : 16, frame_tick, e);
+	if (!e->frame_timer)
+		return kInternalInconsistency;
+	if (task_hz && e->has_platform)
+		e->task_timer = pt_timer_start(0, task_hz < 1000 ? 1000 / task_hz : 1, task_tick, e);
+	return kSuccess;
+}
+
+static FlutterEngineResult stub_shutdown(FLUTTER_API_SYMBOL(FlutterEngine) e)
+{
+	if (!e)
+		return kInvalidArguments;
+
+	pt_rwlock_write_lock(&g_engines_lock);
+	for (int i = 0; i < STUB_MAX_ENGINES; ++i) {
+		if (g_engines[i] == e)
+			g_engines[i] = NULL;
+	}
+	pt_rwlock_write_unlock(&g_engines_lock);
+
+	pt_timer_stop(e->task_timer);
+	pt_timer_stop(e->frame_timer);
+	if (e->has_compositor) {
+		for (int i = 0; i < STUB_MAX_VIEWS; ++i)
+			collect_store(e, &e->stores[i]);
+	}
+	free(e->surface);
+	pt_mutex_destroy(&e->lock);
+	free(e);
+	pt_atomic_dec(&g_stats.engines);
+	return kSuccess;
+}
+
+static void set_view(struct _FlutterEngine *e, FlutterViewId id, const FlutterWindowMetricsEvent *m, bool exists)
+{
+	pt_mutex_lock(&e->lock);
+	e->views[id].exists = exists;
+	e->views[id].width = m ? (uint32_t)m->width : 0;
+	e->views[id].height = m ? (uint32_t)m->height : 0;
+	pt_mutex_unlock(&e->lock);
+}
+
+static FlutterViewId metrics_view_id(const FlutterWindowMetricsEvent *m)
+{
+	return m->struct_size > offsetof(FlutterWindowMetricsEvent, view_id) ? m->view_id : 0;
+}
+
+static FlutterEngineResult stub_send_window_metrics(FLUTTER_API_SYMBOL(FlutterEngine) e,
+						    const FlutterWindowMetricsEvent *event)
+{
+	if (!e || !event)
+		return kInvalidArguments;
+	const FlutterViewId id = metrics_view_id(event);
+	if (id < 0 || id >= STUB_MAX_VIEWS || !e->views[id].exists)
+		return kInvalidArguments;
+	set_view(e, id, event, true);
+	return kSuccess;
+}
+
+static FlutterEngineResult stub_add_view(FLUTTER_API_SYMBOL(FlutterEngine) e, const FlutterAddViewInfo *info)
+{
+	if (!e || !info || info->view_id <= 0 || info->view_id >= STUB_MAX_VIEWS || !info->view_metrics)
+		return kInvalidArguments;
+
+	const bool added = !e->views[info->view_id].exists;
+	if (added)
+		set_view(e, info->view_id, info->view_metrics, true);
+	const FlutterAddViewResult result = {.struct_size = sizeof(result), .added = added, .user_data = info->user_data};
+	info->add_view_callback(&result);
+	return kSuccess;
+}
+
+static FlutterEngineResult stub_remove_view(FLUTTER_API_SYMBOL(FlutterEngine) e, const FlutterRemoveViewInfo *info)
+{
+	if (!e || !info || info->view_id <= 0 || info->view_id >= STUB_MAX_VIEWS) // the implicit view stays
+		return kInvalidArguments;
+
+	set_view(e, info->view_id, NULL, false);
+	const FlutterRemoveViewResult result = {.struct_size = sizeof(result), .removed = true, .user_data = info->user_data};
+	info->remove_view_callback(&result);
+	return kSuccess;
+}
+
+static FlutterEngineResult stub_schedule_frame(FLUTTER_API_SYMBOL(FlutterEngine) e)
+{
+	return e ? kSuccess : kInvalidArguments; // the stub animates continuously
+}
+
+static FlutterEngineResult stub_on_vsync(FLUTTER_API_SYMBOL(FlutterEngine) e, intptr_t baton, uint64_t start,
+					 uint64_t target)
+{
+	(void)target;
+	if (!e || !baton || e->baton != (int64_t)baton)
+		return kInvalidArguments;
+	pt_atomic_xchg64(&e->vsync_start, start ? (int64_t)start : 1);
+	pt_atomic_xchg64(&e->baton, 0);
+	pt_atomic_inc64(&g_stats.vsync_returned);
+	return kSuccess;
+}
+
+static FlutterEngineResult stub_run_task(FLUTTER_API_SYMBOL(FlutterEngine) e, const FlutterTask *task)
+{
+	if (!e || !task || task->runner != (FlutterTaskRunner)e)
+		return kInvalidArguments;
+	pt_atomic_inc64(&g_stats.tasks_run);
+
+	// The app's first platform message: asking for its FFI handle, as Dart does
+	if (!e->handle_requested && e->message_cb) {
+		static const char request[] = "{\"method\":\"handle\"}";
+		struct _FlutterPlatformMessageResponseHandle *handle = malloc(sizeof(*handle));
+		e->handle_requested = true;
+		if (handle) {
+			handle->engine = e;
+			const FlutterPlatformMessage msg = {
+				.struct_size = sizeof(msg),
+				.channel = "obs_ffi",
+				.message = (const uint8_t *)request,
+				.message_size = sizeof(request) - 1,
+				.response_handle = handle,
+			};
+			e->message_cb(&msg, e->user_data);
+		}
+	}
+	return kSuccess;
+}
+
+static FlutterEngineResult stub_send_platform_message(FLUTTER_API_SYMBOL(FlutterEngine) e,
+						      const FlutterPlatformMessage *msg)
+{
+	static const char paused[] = "AppLifecycleState.paused";
+	static const char resumed[] = "AppLifecycleState.resumed";
+	if (!e || !msg || !msg->channel)
+		return kInvalidArguments;
+
+	pt_atomic_inc64(&g_stats.platform_messages);
+	if (strcmp(msg->channel, "flutter/lifecycle") != 0)
+		return kSuccess;
+	if (msg->message_size == sizeof(paused) - 1 && memcmp(msg->message, paused, msg->message_size) == 0) {
+		pt_atomic_xchg(&e->paused, 1);
+		pt_atomic_inc64(&g_stats.paused);
+	} else if (msg->message_size == sizeof(resumed) - 1 && memcmp(msg->message, resumed, msg->message_size) == 0) {
+		pt_atomic_xchg(&e->paused, 0);
+		pt_atomic_inc64(&g_stats.resumed);
+	}
+	return kSuccess;
+}
+
+static FlutterEngineResult stub_send_platform_message_response(FLUTTER_API_SYMBOL(FlutterEngine) e,
+							       const FlutterPlatformMessageResponseHandle *handle,
+							       const uint8_t *data, size_t size)
+{
+	if (!e || !handle || handle->engine != e)
+		return kInvalidArguments;
+
+	// The only request the stub makes is for the FFI handle, answered in decimal
+	char text[32];
+	if (data && size && size < sizeof(text)) {
+		memcpy(text, data, size);
+		text[size] = '\0';
+		pt_atomic_xchg64(&e->ffi_handle, strtoll(text, NULL, 10));
+	}
+	free((void *)handle);
+	return kSuccess;
+}
+
+static FlutterEngineResult stub_post_dart_object(FLUTTER_API_SYMBOL(FlutterEngine) e, FlutterEngineDartPort port,
+						 const FlutterEngineDartObject *object)
+{
+	(void)port;
+	return e && object ? kSuccess : kInvalidArguments;
+}
+
+static FlutterEngineResult stub_post_callback_on_all_native_threads(FLUTTER_API_SYMBOL(FlutterEngine) e,
+								    FlutterNativeThreadCallback callback,
+								    void *user_data)
+{
+	if (!e || !callback)
+		return kInvalidArguments;
+	pt_mutex_lock(&e->lock);
+	e->native_cb = callback;
+	e->native_data = user_data;
+	pt_mutex_unlock(&e->lock);
+	return kSuccess;
+}
+
+static FlutterEngineResult stub_create_aot_data(const FlutterEngineAOTDataSource *source, FlutterEngineAOTData *data_out)
+{
+	if (!source || !data_out || source->type != kFlutterEngineAOTDataSourceTypeElfPath || !source->elf_path)
+		return kInvalidArguments;
+
+	FILE *f = fopen(source->elf_path, "rb");
+	if (!f)
+		return kInvalidArguments;
+	fseek(f, 0, SEEK_END);
+	const long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	struct _FlutterEngineAOTData *data = size >= 0 ? malloc(sizeof(*data) + (size_t)size) : NULL;
+	if (!data || fread(data->bytes, 1, (size_t)size, f) != (size_t)size) {
+		free(data);
+		fclose(f);
+		return kInvalidArguments;
+	}
+	fclose(f);
+
+	data->size = (size_t)size;
+	pt_atomic_inc(&g_stats.aot_data);
+	pt_atomic_add64(&g_stats.aot_bytes, (int64_t)data->size);
+	*data_out = data;
+	return kSuccess;
+}
+
+static FlutterEngineResult stub_collect_aot_data(FlutterEngineAOTData data)
+{
+	if (!data)
+		return kInvalidArguments;
+	pt_atomic_dec(&g_stats.aot_data);
+	pt_atomic_add64(&g_stats.aot_bytes, -(int64_t)data->size);
+	free(data);
+	return kSuccess;
+}
+
+FLUTTER_EXPORT FlutterEngineResult FlutterEngineGetProcAddresses(FlutterEngineProcTable *table)
+{
+	if (!table || table->struct_size < sizeof(*table))
+		return kInvalidArguments;
+
+	table->CreateAOTData = stub_create_aot_data;
+	table->CollectAOTData = stub_collect_aot_data;
+	table->Initialize = stub_initialize;
+	table->RunInitialized = stub_run_initialized;
+	table->Shutdown = stub_shutdown;
+	table->SendWindowMetricsEvent = stub_send_window_metrics;
+	table->SendPlatformMessage = stub_send_platform_message;
+	table->SendPlatformMessageResponse = stub_send_platform_message_response;
+	table->OnVsync = stub_on_vsync;
+	table->GetCurrentTime = stub_current_time;
+	table->RunTask = stub_run_task;
+	table->PostDartObject = stub_post_dart_object;
+	table->PostCallbackOnAllNativeThreads = stub_post_callback_on_all_native_threads;
+	table->ScheduleFrame = stub_schedule_frame;
+	table->AddView = stub_add_view;
+	table->RemoveView = stub_remove_view;
+	return kSuccess;
+}
+
+FLUTTER_EXPORT void stub_engine_get_stats(struct stub_engine_stats *out)
+{
+	*out = (struct stub_engine_stats){
+		.engines = g_stats.engines,
+		.aot_data = g_stats.aot_data,
+		.aot_bytes = (uint64_t)g_stats.aot_bytes,
+		.frames = (uint64_t)g_stats.frames,
+		.tasks_posted = (uint64_t)g_stats.tasks_posted,
+		.tasks_run = (uint64_t)g_stats.tasks_run,
+		.vsync_requests = (uint64_t)g_stats.vsync_requests,
+		.vsync_returned = (uint64_t)g_stats.vsync_returned,
+		.platform_messages = (uint64_t)g_stats.platform_messages,
+		.lifecycle_paused = (uint64_t)g_stats.paused,
+		.lifecycle_resumed = (uint64_t)g_stats.resumed,
+	};
+}
+
+FLUTTER_EXPORT size_t stub_engine_ffi_handles(int64_t *out, size_t cap)
+{
+	size_t n = 0;
+	pt_rwlock_read_lock(&g_engines_lock);
+	for (int i = 0; i < STUB_MAX_ENGINES && n < cap; ++i) {
+		if (g_engines[i] && g_engines[i]->ffi_handle)
+			out[n++] = g_engines[i]->ffi_handle;
+	}
+	pt_rwlock_read_unlock(&g_engines_lock);
+	return n;
+}
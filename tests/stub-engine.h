@@ -0,0 +1,48 @@
+/*
+ * Stub Flutter engine for the headless tests and benchmarks.
+ *
+ * A shared library exporting FlutterEngineGetProcAddresses, so the plug-in
+ * loads it through "engine_library" like any engine build.  It runs no Dart:
+ * each running engine animates continuously, presenting a synthetic frame per
+ * view at a fixed rate.  With a vsync callback registered, each frame waits
+ * for its baton to come back.  It also posts tasks to the embedder's
+ * platform runner; the first task it runs sends "obs_ffi" the request Dart
+ * makes for its FFI handle.  Environment variables set the rates:
+ *
+ *   STUB_ENGINE_FPS      frames per second per engine (60)
+ *   STUB_ENGINE_TASK_HZ  platform tasks per second per engine (120)
+ *   STUB_ENGINE_INIT_MS  time FlutterEngineInitialize takes (0)
+ *
+ * Only the calls the plug-in makes are implemented; the rest of the proc
+ * table stays NULL.  AOT data needs an existing ELF path and "maps" it by
+ * reading it into memory, so the counters below show how many copies exist.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct stub_engine_stats {
+	long engines;        // initialized and not yet shut down
+	long aot_data;       // CreateAOTData results not yet collected
+	uint64_t aot_bytes;  // held by them
+	uint64_t frames;     // presented, all engines and views
+	uint64_t tasks_posted;
+	uint64_t tasks_run;
+	uint64_t vsync_requests;
+	uint64_t vsync_returned; // batons handed back through OnVsync
+	uint64_t platform_messages;
+	uint64_t lifecycle_paused; // "AppLifecycleState.paused" messages
+	uint64_t lifecycle_resumed;
+};
+
+/* Exported by the stub; tests loading it at runtime look the symbol up. */
+void stub_engine_get_stats(struct stub_engine_stats *out);
+typedef void (*stub_engine_get_stats_fn)(struct stub_engine_stats *out);
+
+/* Fills `out` with the obs_flutter_* handles the running engines were given
+ * over "obs_ffi" and returns how many; engines still waiting for their reply
+ * are left out. */
+size_t stub_engine_ffi_handles(int64_t *out, size_t cap);
+typedef size_t (*stub_engine_ffi_handles_fn)(int64_t *out, size_t cap);
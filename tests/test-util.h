@@ -0,0 +1,50 @@
+/*
+ * Checks shared by the headless tests that run against the stub engine.
+ *
+ * CHECK() reports and counts a failure without stopping the test, so one run
+ * shows everything that broke; test_finish() turns the count into the exit
+ * code.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <util/platform.h>
+
+#include "engine-procs.h"
+#include "stub-engine.h"
+
+static int g_failures;
+
+#define CHECK(cond)                                                                          \
+	do {                                                                                 \
+		if (!(cond)) {                                                               \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+			g_failures++;                                                        \
+		}                                                                            \
+	} while (0)
+
+/* Loads the stub engine at `path` into g_embedder and returns its counters,
+ * or exits: nothing else can run without it. */
+static inline stub_engine_get_stats_fn test_load_stub(const char *path)
+{
+	void *lib = path ? os_dlopen(path) : NULL; // a second reference, for the stats export
+	stub_engine_get_stats_fn get_stats = lib ? (stub_engine_get_stats_fn)os_dlsym(lib, "stub_engine_get_stats") : NULL;
+	if (!get_stats || !embedder_load(path)) {
+		fprintf(stderr, "can't load the stub engine from %s\n", path ? path : "(no path given)");
+		exit(1);
+	}
+	return get_stats;
+}
+
+static inline int test_finish(const char *name)
+{
+	if (g_failures) {
+		fprintf(stderr, "%s: %d failure(s)\n", name, g_failures);
+		return 1;
+	}
+	printf("%s: ok\n", name);
+	return 0;
+}